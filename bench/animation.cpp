@@ -0,0 +1,99 @@
+#include "animation.h"
+#include "bench.h"
+#include <cmath>
+
+constexpr std::size_t BENCH_ANIMATION_SPRITES = 100000;
+constexpr std::size_t BENCH_ANIMATION_CLIPS = 8;
+constexpr int BENCH_ANIMATION_TICKS = 600;
+
+// The object per sprite layout the SoA player replaces, each sprite owns its
+// playback state behind a virtual update.
+class BenchAnimated {
+    public:
+        virtual ~BenchAnimated() = default;
+        virtual void update(float dt) = 0;
+        virtual Uint32 frame() const = 0;
+};
+
+class BenchSheetAnimation : public BenchAnimated {
+    public:
+        BenchSheetAnimation(const AnimationClip &animation_clip,
+                            float animation_speed, float start_time)
+            : clip{animation_clip},
+              speed{animation_speed},
+              time{start_time},
+              current{animation_clip.first} {}
+
+        void update(float dt) override {
+            float duration = static_cast<float>(this->clip.frames) /
+                             this->clip.fps;
+            this->time = std::fmod(this->time + dt * this->speed, duration);
+            if (this->time < 0) {
+                this->time += duration;
+            }
+            auto local = static_cast<Uint32>(this->time * this->clip.fps);
+            this->current =
+                this->clip.first + std::min(local, this->clip.frames - 1);
+        }
+
+        Uint32 frame() const override { return this->current; }
+
+    private:
+        AnimationClip clip;
+        float speed;
+        float time;
+        Uint32 current;
+};
+
+// Steps 100k sprites playing a mix of clips at different speeds, once with
+// the SoA player and once as one heap object each, and checks both end on
+// the same frames.
+void benchAnimation() {
+    std::vector<AnimationClip> clips;
+    Uint32 first = 0;
+    for (std::size_t i = 0; i < BENCH_ANIMATION_CLIPS; i++) {
+        auto frames = static_cast<Uint32>(4 + i * 2);
+        clips.push_back({first, frames, 8.0f + static_cast<float>(i) * 2});
+        first += frames;
+    }
+
+    Xoshiro256 gen{1};
+    AnimationPlayer player;
+    std::vector<std::unique_ptr<BenchAnimated>> objects;
+    for (std::size_t i = 0; i < BENCH_ANIMATION_SPRITES; i++) {
+        const AnimationClip &clip = clips[i % clips.size()];
+        float speed = gen.uniform(0.5f, 2);
+        float start =
+            gen.uniform(0, static_cast<float>(clip.frames) / clip.fps);
+        player.add(clip, speed, start);
+        objects.push_back(
+            std::make_unique<BenchSheetAnimation>(clip, speed, start));
+    }
+
+    auto start = BenchClock::now();
+    for (int tick = 0; tick < BENCH_ANIMATION_TICKS; tick++) {
+        player.update(UPDATE_DT);
+    }
+    double soa_ms = benchMs(start, BenchClock::now()) / BENCH_ANIMATION_TICKS;
+
+    start = BenchClock::now();
+    for (int tick = 0; tick < BENCH_ANIMATION_TICKS; tick++) {
+        for (const auto &object : objects) {
+            object->update(UPDATE_DT);
+        }
+    }
+    double object_ms =
+        benchMs(start, BenchClock::now()) / BENCH_ANIMATION_TICKS;
+
+    // Float rounding may put a sprite right at a frame edge a frame apart.
+    std::size_t differ = 0;
+    for (std::size_t i = 0; i < BENCH_ANIMATION_SPRITES; i++) {
+        differ += player.frame(i) != objects[i]->frame();
+    }
+
+    std::cout << std::format(
+        "animation: {} sprites, {} clips, soa {:.3f} ms ({:.2f} ns per "
+        "sprite), virtual {:.3f} ms per tick, {} frames differ\n",
+        BENCH_ANIMATION_SPRITES, clips.size(), soa_ms,
+        soa_ms * 1e6 / BENCH_ANIMATION_SPRITES, object_ms, differ);
+}
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include <algorithm>
+
+std::string benchAssetPath(AssetKind kind) {
+    Scene scene = loadScene(SCENE_PATH);
+    auto asset = std::find_if(
+        scene.assets.begin(), scene.assets.end(),
+        [kind](const SceneAsset &scene_asset) {
+            return scene_asset.kind == kind;
+        });
+    if (asset == scene.assets.end()) {
+        throw std::runtime_error("Error loading Scene: asset kind missing");
+    }
+    return asset->path;
+}
+
+// Decoding the first image of the scene from disk, as a reload would.
+static void benchLoadImage(BenchState &state) {
+    std::string path = benchAssetPath(AssetKind::Image);
+
+    state.setItems(1);
+    while (state.keepRunning()) {
+        SDL_Surface *surf = IMG_Load(path.c_str());
+        if (!surf) {
+            auto error =
+                std::format("Error loading Surface: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        SDL_DestroySurface(surf);
+    }
+}
+
+// Decoding the first sound of the scene into a chunk in the mixer format.
+static void benchLoadSound(BenchState &state) {
+    std::string path = benchAssetPath(AssetKind::Sound);
+
+    state.setItems(1);
+    while (state.keepRunning()) {
+        Mix_Chunk *chunk = Mix_LoadWAV(path.c_str());
+        if (!chunk) {
+            auto error = std::format("Error loading Chunk: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        Mix_FreeChunk(chunk);
+    }
+}
+
+static const BenchRegistration bench_load_image{"assets/load_image",
+                                                benchLoadImage};
+static const BenchRegistration bench_load_sound{"assets/load_sound",
+                                                benchLoadSound};
@@ -0,0 +1,26 @@
+#include "bench.h"
+
+// Starting a sound on a free channel and stopping it again, what a bounce
+// costs the update thread. Needs the mixer opened on the dummy driver.
+static void benchAudioTrigger(BenchState &state) {
+    std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)> chunk{
+        Mix_LoadWAV(benchAssetPath(AssetKind::Sound).c_str()), Mix_FreeChunk};
+    if (!chunk) {
+        auto error = std::format("Error loading Chunk: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    state.setItems(1);
+    while (state.keepRunning()) {
+        int channel = Mix_PlayChannel(-1, chunk.get(), 0);
+        if (channel < 0) {
+            auto error =
+                std::format("Error playing Chunk: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        Mix_HaltChannel(channel);
+    }
+}
+
+static const BenchRegistration bench_audio_trigger{"audio/trigger",
+                                                   benchAudioTrigger};
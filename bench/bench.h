@@ -0,0 +1,155 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "main.h"
+#include "world.h"
+#include <chrono>
+#include <string>
+#include <string_view>
+
+constexpr int BENCH_WIDTH = WINDOW_WIDTH;
+constexpr int BENCH_HEIGHT = WINDOW_HEIGHT;
+constexpr double BENCH_FRAME_BUDGET_MS = 1000.0 / 60.0;
+constexpr SDL_Color BENCH_COLOR = {255, 255, 255, 255};
+
+using BenchClock = std::chrono::steady_clock;
+
+inline double benchMs(BenchClock::time_point start,
+                      BenchClock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// A run of a registered benchmark has to last at least this long, shorter
+// runs are repeated with more iterations.
+constexpr double BENCH_MIN_TIME_MS = 250;
+constexpr Uint64 BENCH_MAX_ITERATIONS = 1000000000;
+
+// Handed to a registered benchmark, in the style of Google Benchmark. Setup
+// goes before the loop and is not timed, the body runs once per
+// keepRunning() that returns true:
+//
+//   while (state.keepRunning()) {
+//       world.update(input);
+//   }
+class BenchState {
+    public:
+        explicit BenchState(Uint64 iteration_count)
+            : iterations{iteration_count},
+              remaining{iteration_count},
+              items{0},
+              start{},
+              end{} {}
+
+        bool keepRunning() {
+            if (this->remaining == this->iterations) {
+                this->start = BenchClock::now();
+            }
+            if (this->remaining > 0) {
+                this->remaining--;
+                return true;
+            }
+            this->end = BenchClock::now();
+            return false;
+        }
+
+        // Things processed per iteration, such as sprites or entities, for
+        // the items per second column.
+        void setItems(Uint64 items_per_iteration) {
+            this->items = items_per_iteration;
+        }
+
+        Uint64 iterationCount() const { return this->iterations; }
+        Uint64 itemCount() const { return this->items; }
+        double ms() const { return benchMs(this->start, this->end); }
+
+    private:
+        Uint64 iterations;
+        Uint64 remaining;
+        Uint64 items;
+        BenchClock::time_point start;
+        BenchClock::time_point end;
+};
+
+using BenchFunction = void (*)(BenchState &state);
+
+// Adds a benchmark to the suite, names group as area/case. Benchmarks
+// register from a static BenchRegistration in the file of their area.
+void benchRegister(const char *name, BenchFunction function);
+
+struct BenchRegistration {
+        BenchRegistration(const char *name, BenchFunction function) {
+            benchRegister(name, function);
+        }
+};
+
+// Keeps the compiler from dropping a result that is otherwise unused.
+template <typename T> inline void benchKeep(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs every registered benchmark whose name contains filter and prints a
+// table, with a json_path also as Google Benchmark compatible JSON.
+void benchRunSuite(std::string_view filter, const char *json_path);
+
+// A software renderer drawing into an offscreen surface, so benchmarks run
+// the same code as Game::draw without needing a window or a GPU.
+class BenchRenderer {
+    public:
+        BenchRenderer()
+            : surface{SDL_CreateSurface(BENCH_WIDTH, BENCH_HEIGHT,
+                                        SDL_PIXELFORMAT_ARGB8888),
+                      SDL_DestroySurface},
+              renderer{nullptr, SDL_DestroyRenderer} {
+            if (!this->surface) {
+                auto error =
+                    std::format("Error creating Surface: {}", SDL_GetError());
+                throw std::runtime_error(error);
+            }
+            this->renderer.reset(
+                SDL_CreateSoftwareRenderer(this->surface.get()));
+            if (!this->renderer) {
+                auto error =
+                    std::format("Error creating Renderer: {}", SDL_GetError());
+                throw std::runtime_error(error);
+            }
+        }
+
+        SDL_Renderer *get() const { return this->renderer.get(); }
+
+    private:
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface;
+        std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer;
+};
+
+// The default scene with made up sprite sizes, so world benchmarks run
+// without loading any images or fonts.
+WorldSetup benchWorldSetup(std::size_t particle_capacity);
+
+// Scene text with the logo as a player and that many bouncing entities.
+std::string benchSceneText(std::size_t entities);
+
+// The path of the first asset of that kind in the default scene.
+std::string benchAssetPath(AssetKind kind);
+
+// The first font of the default scene at size.
+std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> benchFont(float size);
+
+void benchParticles();
+void benchTilemap();
+void benchCulling();
+void benchCommandBuffer();
+void benchFramePacer();
+void benchWorlds();
+void benchRandom();
+void benchSnapshot();
+void benchScene();
+void benchText();
+void benchSdf();
+void benchBlit();
+void benchRaster();
+void benchStreaming();
+void benchResolution();
+void benchAnimation();
+void benchTransform();
+
+#endif
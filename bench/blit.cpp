@@ -0,0 +1,130 @@
+#include "bench.h"
+#include "blit.h"
+#include "image_compare.h"
+#include <cstring>
+
+constexpr int BENCH_BLIT_ROUNDS = 200;
+constexpr int BENCH_BLIT_SPRITES = 200;
+constexpr int BENCH_BLIT_SPRITE_SIZE = 64;
+
+using BenchSurface =
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>;
+
+static BenchSurface benchSurface(int w, int h, SDL_PixelFormat format,
+                                 Uint32 seed, bool translucent) {
+    BenchSurface surf{SDL_CreateSurface(w, h, format), SDL_DestroySurface};
+    if (!surf) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    Xoshiro256 gen{seed};
+    for (int y = 0; y < h; y++) {
+        Uint32 *row = reinterpret_cast<Uint32 *>(
+            static_cast<Uint8 *>(surf->pixels) + y * surf->pitch);
+        for (int x = 0; x < w; x++) {
+            auto pixel = static_cast<Uint32>(gen());
+            row[x] = translucent ? pixel : pixel | 0xFF000000;
+        }
+    }
+    return surf;
+}
+
+struct BlitCase {
+        const char *name;
+        SDL_PixelFormat src_format;
+        SDL_PixelFormat dst_format;
+        bool sprites;
+        BlitBlend blend;
+        int scale;
+        double angle;
+};
+
+// Times each specialized kernel against SDL_BlitSurface doing the same work
+// and checks both wrote the same pixels. SDL has no rotating surface blit,
+// so rotation is timed on its own.
+void benchBlit() {
+    constexpr std::array<BlitCase, 5> cases = {{
+        {"background copy", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888,
+         false, BlitBlend::None, 1, 0},
+        {"converting copy", SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888,
+         false, BlitBlend::None, 1, 0},
+        {"sprite blend", SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888,
+         true, BlitBlend::Blend, 1, 0},
+        {"scaled sprite blend", SDL_PIXELFORMAT_ABGR8888,
+         SDL_PIXELFORMAT_ARGB8888, true, BlitBlend::Blend, 2, 0},
+        {"rotated sprite blend", SDL_PIXELFORMAT_ABGR8888,
+         SDL_PIXELFORMAT_ARGB8888, true, BlitBlend::Blend, 1, 30},
+    }};
+
+    for (const BlitCase &test : cases) {
+        int src_w = test.sprites ? BENCH_BLIT_SPRITE_SIZE : BENCH_WIDTH;
+        int src_h = test.sprites ? BENCH_BLIT_SPRITE_SIZE : BENCH_HEIGHT;
+        int count = test.sprites ? BENCH_BLIT_SPRITES : 1;
+        BenchSurface src =
+            benchSurface(src_w, src_h, test.src_format, 1, test.sprites);
+        BenchSurface backdrop = benchSurface(BENCH_WIDTH, BENCH_HEIGHT,
+                                             test.dst_format, 2, false);
+        BenchSurface ours = benchSurface(BENCH_WIDTH, BENCH_HEIGHT,
+                                         test.dst_format, 2, false);
+        BenchSurface sdl = benchSurface(BENCH_WIDTH, BENCH_HEIGHT,
+                                        test.dst_format, 2, false);
+
+        std::vector<SDL_Rect> rects;
+        Xoshiro256 gen{3};
+        for (int i = 0; i < count; i++) {
+            int w = src_w * test.scale;
+            int h = src_h * test.scale;
+            float max_x = static_cast<float>(BENCH_WIDTH - w / 2);
+            float max_y = static_cast<float>(BENCH_HEIGHT - h / 2);
+            rects.push_back({static_cast<int>(gen.uniform(0, max_x)),
+                             static_cast<int>(gen.uniform(0, max_y)), w, h});
+        }
+
+        auto reset = [&backdrop](SDL_Surface *surf) {
+            std::memcpy(surf->pixels, backdrop->pixels,
+                        static_cast<std::size_t>(surf->pitch) *
+                            static_cast<std::size_t>(surf->h));
+        };
+
+        double ours_ms = 0;
+        for (int round = 0; round < BENCH_BLIT_ROUNDS; round++) {
+            reset(ours.get());
+            auto start = BenchClock::now();
+            for (const SDL_Rect &rect : rects) {
+                blitSurface(src.get(), nullptr, ours.get(), &rect, test.blend,
+                            test.angle);
+            }
+            ours_ms += benchMs(start, BenchClock::now());
+        }
+
+        std::string sdl_result = "no SDL equivalent";
+        if (test.angle <= 0) {
+            SDL_SetSurfaceBlendMode(src.get(), test.blend == BlitBlend::Blend
+                                                   ? SDL_BLENDMODE_BLEND
+                                                   : SDL_BLENDMODE_NONE);
+            double sdl_ms = 0;
+            for (int round = 0; round < BENCH_BLIT_ROUNDS; round++) {
+                reset(sdl.get());
+                auto start = BenchClock::now();
+                for (const SDL_Rect &rect : rects) {
+                    if (test.scale == 1) {
+                        SDL_BlitSurface(src.get(), nullptr, sdl.get(), &rect);
+                    } else {
+                        SDL_BlitSurfaceScaled(src.get(), nullptr, sdl.get(),
+                                              &rect, SDL_SCALEMODE_NEAREST);
+                    }
+                }
+                sdl_ms += benchMs(start, BenchClock::now());
+            }
+            ImageDiff diff = compareImages(sdl.get(), ours.get(), 1);
+            sdl_result = std::format("SDL {:.3f} ms, {} pixels differ by more "
+                                     "than 1",
+                                     sdl_ms / BENCH_BLIT_ROUNDS,
+                                     diff.differing);
+        }
+
+        std::cout << std::format("blit: {} x{}, ours {:.3f} ms, {}\n",
+                                 test.name, count, ours_ms / BENCH_BLIT_ROUNDS,
+                                 sdl_result);
+    }
+}
@@ -0,0 +1,166 @@
+#include "bench.h"
+#include "command_buffer.h"
+#include <thread>
+
+constexpr int BENCH_COMMAND_SPRITES = 100000;
+constexpr int BENCH_COMMAND_TEXTURES = 4;
+constexpr int BENCH_COMMAND_FRAMES = 50;
+constexpr int BENCH_COMMAND_SPRITE_SIZE = 200;
+constexpr int BENCH_COMMAND_PAGE_SIZE = 256;
+constexpr std::size_t BENCH_COMMAND_SUITE_SPRITES = 10000;
+
+// Small pages force every sprite image onto its own texture.
+static std::vector<AtlasRegion> benchRegions(TextureAtlas &atlas,
+                                             SDL_Renderer *renderer) {
+    std::vector<AtlasRegion> regions;
+    for (int i = 0; i < BENCH_COMMAND_TEXTURES; i++) {
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+            SDL_CreateSurface(BENCH_COMMAND_SPRITE_SIZE,
+                              BENCH_COMMAND_SPRITE_SIZE,
+                              SDL_PIXELFORMAT_RGBA32),
+            SDL_DestroySurface};
+        if (!surface) {
+            auto error =
+                std::format("Error creating Surface: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        regions.push_back(atlas.add(std::format("sprite{}", i), surface.get()));
+    }
+    atlas.build(renderer);
+    return regions;
+}
+
+static std::vector<SDL_FRect> benchSpriteRects() {
+    std::mt19937 gen{1};
+    std::uniform_real_distribution<float> rand_x{0, BENCH_WIDTH};
+    std::uniform_real_distribution<float> rand_y{0, BENCH_HEIGHT};
+    std::vector<SDL_FRect> rects(BENCH_COMMAND_SUITE_SPRITES);
+    for (SDL_FRect &rect : rects) {
+        rect = {rand_x(gen), rand_y(gen), 16, 16};
+    }
+    return rects;
+}
+
+// Recording and sorting a frame of sprites on one thread, the regions
+// alternate so the sort has every batch to merge.
+static void benchSpriteRecordSort(BenchState &state) {
+    BenchRenderer renderer;
+    TextureAtlas atlas{BENCH_COMMAND_PAGE_SIZE};
+    std::vector<AtlasRegion> regions = benchRegions(atlas, renderer.get());
+    std::vector<SDL_FRect> rects = benchSpriteRects();
+    CommandBuffer commands{atlas};
+
+    state.setItems(rects.size());
+    while (state.keepRunning()) {
+        commands.clear();
+        for (std::size_t i = 0; i < rects.size(); i++) {
+            commands.add(RenderLayer::Sprites, regions[i % regions.size()],
+                         rects[i]);
+        }
+        commands.sort();
+        benchKeep(commands.batches());
+    }
+}
+
+static void benchSpriteSubmit(BenchState &state) {
+    BenchRenderer renderer;
+    TextureAtlas atlas{BENCH_COMMAND_PAGE_SIZE};
+    std::vector<AtlasRegion> regions = benchRegions(atlas, renderer.get());
+    std::vector<SDL_FRect> rects = benchSpriteRects();
+    CommandBuffer commands{atlas};
+    for (std::size_t i = 0; i < rects.size(); i++) {
+        commands.add(RenderLayer::Sprites, regions[i % regions.size()],
+                     rects[i]);
+    }
+    commands.sort();
+
+    state.setItems(rects.size());
+    while (state.keepRunning()) {
+        commands.submit(renderer.get());
+    }
+}
+
+static const BenchRegistration bench_sprite_record_sort{
+    "sprites/record_sort", benchSpriteRecordSort};
+static const BenchRegistration bench_sprite_submit{"sprites/submit",
+                                                   benchSpriteSubmit};
+
+void benchCommandBuffer() {
+    BenchRenderer renderer;
+    TextureAtlas atlas{BENCH_COMMAND_PAGE_SIZE};
+    std::vector<AtlasRegion> regions = benchRegions(atlas, renderer.get());
+
+    std::mt19937 gen{1};
+    std::uniform_real_distribution<float> rand_x{0, BENCH_WIDTH};
+    std::uniform_real_distribution<float> rand_y{0, BENCH_HEIGHT};
+    std::uniform_int_distribution<std::size_t> rand_region{
+        0, BENCH_COMMAND_TEXTURES - 1};
+
+    struct Sprite {
+            SDL_FRect rect;
+            std::size_t region;
+    };
+    std::vector<Sprite> sprites(BENCH_COMMAND_SPRITES);
+    for (Sprite &sprite : sprites) {
+        sprite = {{rand_x(gen), rand_y(gen), 16, 16}, rand_region(gen)};
+    }
+
+    std::size_t switches = 0;
+    for (std::size_t i = 1; i < sprites.size(); i++) {
+        if (sprites[i].region != sprites[i - 1].region) {
+            switches++;
+        }
+    }
+
+    std::size_t workers = std::max(1, SDL_GetNumLogicalCPUCores());
+    std::vector<CommandBuffer> buffers(workers, CommandBuffer{atlas});
+    CommandBuffer commands{atlas};
+
+    double record_ms = 0;
+    double sort_ms = 0;
+    double submit_ms = 0;
+
+    for (int frame = 0; frame < BENCH_COMMAND_FRAMES; frame++) {
+        auto start = BenchClock::now();
+        std::vector<std::thread> threads;
+        std::size_t slice = (sprites.size() + workers - 1) / workers;
+        for (std::size_t w = 0; w < workers; w++) {
+            threads.emplace_back([&, w] {
+                CommandBuffer &buffer = buffers[w];
+                buffer.clear();
+                std::size_t end = std::min(sprites.size(), (w + 1) * slice);
+                for (std::size_t i = w * slice; i < end; i++) {
+                    buffer.add(RenderLayer::Sprites,
+                               regions[sprites[i].region], sprites[i].rect);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        commands.clear();
+        for (const CommandBuffer &buffer : buffers) {
+            commands.append(buffer);
+        }
+        auto recorded = BenchClock::now();
+
+        commands.sort();
+        auto sorted = BenchClock::now();
+
+        SDL_RenderClear(renderer.get());
+        commands.submit(renderer.get());
+        SDL_RenderPresent(renderer.get());
+        auto submitted = BenchClock::now();
+
+        record_ms += benchMs(start, recorded);
+        sort_ms += benchMs(recorded, sorted);
+        submit_ms += benchMs(sorted, submitted);
+    }
+
+    std::cout << std::format(
+        "command buffer: {} sprites, {} workers, texture switches {} -> {}, "
+        "record {:.3f} ms, sort {:.3f} ms, submit {:.3f} ms\n",
+        commands.size(), workers, switches, commands.batches() - 1,
+        record_ms / BENCH_COMMAND_FRAMES, sort_ms / BENCH_COMMAND_FRAMES,
+        submit_ms / BENCH_COMMAND_FRAMES);
+}
@@ -0,0 +1,65 @@
+#include "bench.h"
+#include "command_buffer.h"
+
+constexpr int BENCH_CULLING_SPRITES = 100000;
+constexpr int BENCH_CULLING_FRAMES = 100;
+constexpr float BENCH_CULLING_WORLD_SCALE = 20;
+constexpr int BENCH_CULLING_SPRITE_SIZE = 32;
+
+void benchCulling() {
+    BenchRenderer renderer;
+    TextureAtlas atlas;
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> sprite_surf{
+        SDL_CreateSurface(BENCH_CULLING_SPRITE_SIZE, BENCH_CULLING_SPRITE_SIZE,
+                          SDL_PIXELFORMAT_RGBA32),
+        SDL_DestroySurface};
+    if (!sprite_surf) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    const AtlasRegion &region = atlas.add("sprite", sprite_surf.get());
+    atlas.build(renderer.get());
+
+    const float world_w = BENCH_WIDTH * BENCH_CULLING_WORLD_SCALE;
+    const float world_h = BENCH_HEIGHT * BENCH_CULLING_WORLD_SCALE;
+    std::mt19937 gen{1};
+    std::uniform_real_distribution<float> rand_x{0, world_w};
+    std::uniform_real_distribution<float> rand_y{0, world_h};
+
+    std::vector<SDL_FRect> world(BENCH_CULLING_SPRITES);
+    for (SDL_FRect &rect : world) {
+        rect = {rand_x(gen), rand_y(gen), BENCH_CULLING_SPRITE_SIZE,
+                BENCH_CULLING_SPRITE_SIZE};
+    }
+
+    Camera camera{BENCH_WIDTH, BENCH_HEIGHT};
+    camera.centerOn(world_w / 2, world_h / 2);
+    CommandBuffer commands{atlas};
+
+    for (bool cull : {false, true}) {
+        double frame_ms = 0;
+        for (int frame = 0; frame < BENCH_CULLING_FRAMES; frame++) {
+            auto start = BenchClock::now();
+            commands.clear();
+            for (const SDL_FRect &rect : world) {
+                if (cull) {
+                    commands.add(RenderLayer::Sprites, region, rect, camera);
+                } else {
+                    commands.add(RenderLayer::Sprites, region,
+                                 camera.toScreen(rect));
+                }
+            }
+            commands.sort();
+            SDL_RenderClear(renderer.get());
+            commands.submit(renderer.get());
+            SDL_RenderPresent(renderer.get());
+            frame_ms += benchMs(start, BenchClock::now());
+        }
+
+        std::cout << std::format("culling: {}, {} sprites, drawn {}, culled "
+                                 "{}, frame {:.3f} ms\n",
+                                 cull ? "on" : "off", BENCH_CULLING_SPRITES,
+                                 commands.size(), commands.culled(),
+                                 frame_ms / BENCH_CULLING_FRAMES);
+    }
+}
@@ -0,0 +1,33 @@
+#include "bench.h"
+#include "frame_pacer.h"
+#include <array>
+
+constexpr int BENCH_PACER_FRAMES = 120;
+constexpr std::array<float, 2> BENCH_PACER_RATES = {60, 144};
+
+static void printStats(const char *name, float hz, const FrameStats &stats) {
+    std::cout << std::format("frame pacing: {} at {} Hz, mean {:.3f} ms, "
+                             "jitter {:.3f} ms, min {:.3f} ms, max {:.3f} ms\n",
+                             name, hz, stats.mean_ms, stats.jitter_ms,
+                             stats.min_ms, stats.max_ms);
+}
+
+void benchFramePacer() {
+    for (float hz : BENCH_PACER_RATES) {
+        FramePacer pacer;
+        pacer.setRate(hz);
+        for (int frame = 0; frame <= BENCH_PACER_FRAMES; frame++) {
+            pacer.wait();
+        }
+        printStats("sleep+spin", hz, pacer.stats());
+    }
+
+    // The old loop for comparison, a plain millisecond sleep per frame.
+    FramePacer delay;
+    delay.setRate(1000);
+    for (int frame = 0; frame <= BENCH_PACER_FRAMES; frame++) {
+        SDL_Delay(16);
+        delay.wait();
+    }
+    printStats("SDL_Delay(16)", 60, delay.stats());
+}
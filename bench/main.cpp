@@ -0,0 +1,65 @@
+#include "bench.h"
+#include "context.h"
+#include <SDL3/SDL_main.h>
+
+// --filter runs only the registered benchmarks whose name contains the
+// value and skips the reports, --json also writes the results to a file.
+int main(int argc, char *argv[]) {
+    int exit_val = EXIT_SUCCESS;
+
+    try {
+        std::string_view filter;
+        const char *json_path = nullptr;
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg != "--filter" && arg != "--json") {
+                auto error = std::format("Unknown option: {}", arg);
+                throw std::runtime_error(error);
+            }
+            if (i + 1 >= argc) {
+                auto error = std::format("Missing value for option: {}", arg);
+                throw std::runtime_error(error);
+            }
+            i++;
+            if (arg == "--filter") {
+                filter = argv[i];
+            } else {
+                json_path = argv[i];
+            }
+        }
+
+        // Audio and video run on the dummy drivers, so results do not
+        // depend on the machine having a display or a sound card.
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+        SdlContext context;
+
+        benchRunSuite(filter, json_path);
+        if (!filter.empty()) {
+            return exit_val;
+        }
+
+        benchParticles();
+        benchTilemap();
+        benchCulling();
+        benchCommandBuffer();
+        benchFramePacer();
+        benchWorlds();
+        benchRandom();
+        benchSnapshot();
+        benchScene();
+        benchText();
+        benchSdf();
+        benchBlit();
+        benchRaster();
+        benchStreaming();
+        benchResolution();
+        benchAnimation();
+        benchTransform();
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+        exit_val = EXIT_FAILURE;
+    }
+
+    return exit_val;
+}
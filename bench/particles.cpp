@@ -0,0 +1,45 @@
+#include "bench.h"
+#include "particles.h"
+
+constexpr std::size_t BENCH_PARTICLES = 200000;
+constexpr int BENCH_PARTICLE_FRAMES = 300;
+
+void benchParticles() {
+    BenchRenderer renderer;
+    Camera camera{BENCH_WIDTH, BENCH_HEIGHT};
+    ParticleSystem particles{BENCH_PARTICLES};
+    ParticleVertices vertices{BENCH_PARTICLES};
+    particles.seed(1);
+
+    double update_ms = 0;
+    double draw_ms = 0;
+
+    for (int frame = 0; frame < BENCH_PARTICLE_FRAMES; frame++) {
+        // Keep the system saturated so every frame simulates the full count.
+        particles.emit(BENCH_WIDTH / 2.0f, BENCH_HEIGHT / 2.0f,
+                       particles.capacity() - particles.size(), BENCH_COLOR);
+
+        auto start = BenchClock::now();
+        particles.update(UPDATE_DT);
+        particles.batch(camera, vertices);
+        auto updated = BenchClock::now();
+
+        SDL_RenderClear(renderer.get());
+        particles.draw(renderer.get(), vertices);
+        SDL_RenderPresent(renderer.get());
+        auto drawn = BenchClock::now();
+
+        update_ms += benchMs(start, updated);
+        draw_ms += benchMs(updated, drawn);
+    }
+
+    update_ms /= BENCH_PARTICLE_FRAMES;
+    draw_ms /= BENCH_PARTICLE_FRAMES;
+    double frame_ms = update_ms + draw_ms;
+
+    std::cout << std::format("particles: {} particles, update {:.3f} ms, "
+                             "draw {:.3f} ms, frame {:.3f} ms ({})\n",
+                             BENCH_PARTICLES, update_ms, draw_ms, frame_ms,
+                             frame_ms <= BENCH_FRAME_BUDGET_MS ? "within 60 Hz"
+                                                               : "over 60 Hz");
+}
@@ -0,0 +1,50 @@
+#include "bench.h"
+#include "random.h"
+#include <numeric>
+#include <vector>
+
+constexpr std::size_t BENCH_RANDOM_COUNT = 4096;
+constexpr int BENCH_RANDOM_ROUNDS = 2500;
+
+// Refills the same cache sized buffer three ways and reports nanoseconds per
+// float. The sums are printed so the compiler cannot drop the work.
+void benchRandom() {
+    std::vector<float> values(BENCH_RANDOM_COUNT);
+
+    std::mt19937 mt{1};
+    std::uniform_real_distribution<float> dist{0, 1};
+    auto start = BenchClock::now();
+    for (int round = 0; round < BENCH_RANDOM_ROUNDS; round++) {
+        for (float &value : values) {
+            value = dist(mt);
+        }
+    }
+    double mt_ms = benchMs(start, BenchClock::now());
+    float mt_sum = std::accumulate(values.begin(), values.end(), 0.0f);
+
+    Xoshiro256 xoshiro{1};
+    start = BenchClock::now();
+    for (int round = 0; round < BENCH_RANDOM_ROUNDS; round++) {
+        for (float &value : values) {
+            value = xoshiro.uniform();
+        }
+    }
+    double xoshiro_ms = benchMs(start, BenchClock::now());
+    float xoshiro_sum = std::accumulate(values.begin(), values.end(), 0.0f);
+
+    RandomBulk bulk{1};
+    start = BenchClock::now();
+    for (int round = 0; round < BENCH_RANDOM_ROUNDS; round++) {
+        bulk.fill(values.data(), values.size(), 0, 1);
+    }
+    double bulk_ms = benchMs(start, BenchClock::now());
+    float bulk_sum = std::accumulate(values.begin(), values.end(), 0.0f);
+
+    const double to_ns =
+        1e6 / static_cast<double>(BENCH_RANDOM_COUNT * BENCH_RANDOM_ROUNDS);
+    std::cout << std::format("random: mt19937 {:.2f} ns, xoshiro256** {:.2f} "
+                             "ns, bulk {:.2f} ns per float (sums {:.0f} {:.0f} "
+                             "{:.0f})\n",
+                             mt_ms * to_ns, xoshiro_ms * to_ns,
+                             bulk_ms * to_ns, mt_sum, xoshiro_sum, bulk_sum);
+}
@@ -0,0 +1,142 @@
+#include "bench.h"
+#include "soft_raster.h"
+
+constexpr int BENCH_RASTER_WIDTH = 1920;
+constexpr int BENCH_RASTER_HEIGHT = 1080;
+constexpr int BENCH_RASTER_PAGE_SIZE = 2048;
+constexpr int BENCH_RASTER_SPRITES = 2000;
+constexpr int BENCH_RASTER_SPRITE_SIZE = 64;
+constexpr int BENCH_RASTER_PARTICLES = 20000;
+constexpr float BENCH_RASTER_PARTICLE_SIZE = 6;
+constexpr int BENCH_RASTER_FRAMES = 30;
+
+using BenchSurface =
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>;
+
+static BenchSurface benchImage(int w, int h, bool round) {
+    BenchSurface surf{SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32),
+                      SDL_DestroySurface};
+    if (!surf) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    float radius = static_cast<float>(w) / 2;
+    for (int y = 0; y < h; y++) {
+        Uint32 *row = reinterpret_cast<Uint32 *>(
+            static_cast<Uint8 *>(surf->pixels) + y * surf->pitch);
+        for (int x = 0; x < w; x++) {
+            float dx = static_cast<float>(x) + 0.5f - radius;
+            float dy = static_cast<float>(y) + 0.5f - radius;
+            bool inside = !round || dx * dx + dy * dy < radius * radius;
+            Uint32 alpha = inside ? 0xFF000000 : 0;
+            row[x] = alpha | static_cast<Uint32>(y * 255 / h) << 8 |
+                     static_cast<Uint32>(x * 255 / w);
+        }
+    }
+    return surf;
+}
+
+// A 1080p frame of the kind the game draws: a full screen background,
+// sprites blended over it and many small additive particle quads. The
+// rasterizer is timed with one thread and then with every core, against
+// SDL's own software renderer drawing the same sorted buffer.
+void benchRaster() {
+    BenchSurface screen{SDL_CreateSurface(BENCH_RASTER_WIDTH,
+                                          BENCH_RASTER_HEIGHT,
+                                          SDL_PIXELFORMAT_RGBA32),
+                        SDL_DestroySurface};
+    if (!screen) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer{
+        SDL_CreateSoftwareRenderer(screen.get()), SDL_DestroyRenderer};
+    if (!renderer) {
+        auto error = std::format("Error creating Renderer: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    TextureAtlas atlas{BENCH_RASTER_PAGE_SIZE};
+    AtlasRegion background = atlas.add(
+        "background",
+        benchImage(BENCH_RASTER_WIDTH, BENCH_RASTER_HEIGHT, false).get());
+    AtlasRegion sprite = atlas.add(
+        "sprite",
+        benchImage(BENCH_RASTER_SPRITE_SIZE, BENCH_RASTER_SPRITE_SIZE, true)
+            .get());
+    atlas.build(renderer.get());
+
+    Xoshiro256 gen{1};
+    CommandBuffer commands{atlas};
+    commands.add(RenderLayer::Background, background,
+                 {0, 0, BENCH_RASTER_WIDTH, BENCH_RASTER_HEIGHT});
+    for (int i = 0; i < BENCH_RASTER_SPRITES; i++) {
+        commands.add(RenderLayer::Sprites, sprite,
+                     {gen.uniform(-32, BENCH_RASTER_WIDTH),
+                      gen.uniform(-32, BENCH_RASTER_HEIGHT),
+                      BENCH_RASTER_SPRITE_SIZE, BENCH_RASTER_SPRITE_SIZE});
+    }
+
+    std::vector<float> xy;
+    std::vector<SDL_FColor> colors;
+    std::vector<int> indices;
+    for (int i = 0; i < BENCH_RASTER_PARTICLES; i++) {
+        float x = gen.uniform(0, BENCH_RASTER_WIDTH);
+        float y = gen.uniform(0, BENCH_RASTER_HEIGHT);
+        float size = BENCH_RASTER_PARTICLE_SIZE;
+        xy.insert(xy.end(), {x, y, x + size, y, x + size, y + size, x,
+                             y + size});
+        SDL_FColor color{gen.uniform(0, 1), gen.uniform(0, 1), 1, 0.5f};
+        colors.insert(colors.end(), 4, color);
+        int first = i * 4;
+        indices.insert(indices.end(), {first, first + 1, first + 2,
+                                       first + 2, first + 3, first});
+    }
+    commands.addGeometry(RenderLayer::Particles, nullptr, SDL_BLENDMODE_ADD,
+                         xy.data(), colors.data(), nullptr,
+                         static_cast<int>(colors.size()), indices.data(),
+                         static_cast<int>(indices.size()));
+    commands.sort();
+
+    auto start = BenchClock::now();
+    for (int frame = 0; frame < BENCH_RASTER_FRAMES; frame++) {
+        SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255);
+        SDL_RenderClear(renderer.get());
+        commands.submit(renderer.get());
+        SDL_RenderPresent(renderer.get());
+    }
+    double sdl_ms = benchMs(start, BenchClock::now()) / BENCH_RASTER_FRAMES;
+    std::cout << std::format("raster: {}x{}, {} commands, SDL software "
+                             "renderer {:.3f} ms\n",
+                             BENCH_RASTER_WIDTH, BENCH_RASTER_HEIGHT,
+                             commands.size(), sdl_ms);
+
+    auto cores =
+        static_cast<std::size_t>(std::max(1, SDL_GetNumLogicalCPUCores()));
+    double single_ms = 0;
+    for (std::size_t threads = 1; threads <= cores; threads *= 2) {
+        if (threads * 2 > cores) {
+            threads = cores;
+        }
+        SoftRasterizer rasterizer;
+        rasterizer.setup(BENCH_RASTER_WIDTH, BENCH_RASTER_HEIGHT, threads);
+        rasterizer.addTexture(atlas.texture(0), atlas.surface(0));
+
+        rasterizer.draw(commands, {0, 0, 0, 255});
+        start = BenchClock::now();
+        for (int frame = 0; frame < BENCH_RASTER_FRAMES; frame++) {
+            rasterizer.draw(commands, {0, 0, 0, 255});
+        }
+        double ms = benchMs(start, BenchClock::now()) / BENCH_RASTER_FRAMES;
+        if (threads == 1) {
+            single_ms = ms;
+        }
+
+        RasterStats stats = rasterizer.stats();
+        std::cout << std::format(
+            "raster: {} threads, {:.3f} ms, speedup {:.2f}x, {} triangles "
+            "binned {} times into {} tiles\n",
+            threads, ms, single_ms / ms, stats.triangles, stats.binned,
+            stats.tiles);
+    }
+}
@@ -0,0 +1,116 @@
+#include "bench.h"
+#include "command_buffer.h"
+#include "dynamic_resolution.h"
+
+constexpr int BENCH_RESOLUTION_SPRITES = 2000;
+constexpr int BENCH_RESOLUTION_SPRITE_SIZE = 64;
+// A change holds for this many frames, so the timed frames all run at the
+// scale the controller was walked to.
+constexpr int BENCH_RESOLUTION_FRAMES = DYNAMIC_RESOLUTION_SETTLE_FRAMES;
+
+struct ResolutionPhase {
+        const char *name;
+        int frames;
+        double fixed_ms;
+        double fill_ms;
+};
+
+// Drives the controller with a made up cost, a fixed part plus a fill part
+// that shrinks with the rendered area, through a light, a heavy and a light
+// stretch again. Reports where the scale settled and how many frames went
+// over budget compared to always rendering at full size.
+static void benchResolutionController(SDL_Renderer *renderer) {
+    constexpr std::array<ResolutionPhase, 3> phases = {{
+        {"light", 300, 2, 6},
+        {"heavy", 600, 2, 24},
+        {"light again", 600, 2, 6},
+    }};
+
+    DynamicResolution resolution;
+    resolution.setup(renderer, BENCH_WIDTH, BENCH_HEIGHT,
+                     BENCH_FRAME_BUDGET_MS);
+    for (const ResolutionPhase &phase : phases) {
+        int over = 0;
+        int over_full = 0;
+        int changes = 0;
+        double total_ms = 0;
+        for (int frame = 0; frame < phase.frames; frame++) {
+            double area = resolution.scale() * resolution.scale();
+            double ms = phase.fixed_ms + phase.fill_ms * area;
+            over += ms > BENCH_FRAME_BUDGET_MS;
+            over_full +=
+                phase.fixed_ms + phase.fill_ms > BENCH_FRAME_BUDGET_MS;
+            total_ms += ms;
+
+            float before = resolution.scale();
+            resolution.update(ms);
+            changes += before < resolution.scale() ||
+                       before > resolution.scale();
+        }
+        std::cout << std::format(
+            "resolution: {} {} frames, settled at {:.0f}% after {} changes, "
+            "mean {:.2f} ms, {} over budget ({} at full size)\n",
+            phase.name, phase.frames, resolution.scale() * 100, changes,
+            total_ms / phase.frames, over, over_full);
+    }
+}
+
+// What each scale actually costs the software renderer drawing a frame of
+// blended sprites through the scaled target.
+static void benchResolutionScales(SDL_Renderer *renderer) {
+    TextureAtlas atlas;
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+        SDL_CreateSurface(BENCH_RESOLUTION_SPRITE_SIZE,
+                          BENCH_RESOLUTION_SPRITE_SIZE,
+                          SDL_PIXELFORMAT_RGBA32),
+        SDL_DestroySurface};
+    if (!surface) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    SDL_FillSurfaceRect(surface.get(), nullptr, 0x80FFFFFF);
+    AtlasRegion region = atlas.add("sprite", surface.get());
+    atlas.build(renderer);
+
+    Xoshiro256 gen{1};
+    CommandBuffer commands{atlas};
+    for (int i = 0; i < BENCH_RESOLUTION_SPRITES; i++) {
+        commands.add(RenderLayer::Sprites, region,
+                     {gen.uniform(0, BENCH_WIDTH), gen.uniform(0, BENCH_HEIGHT),
+                      BENCH_RESOLUTION_SPRITE_SIZE,
+                      BENCH_RESOLUTION_SPRITE_SIZE});
+    }
+    commands.sort();
+
+    for (int level = 0; level <= DYNAMIC_RESOLUTION_LEVELS; level++) {
+        float scale =
+            1.0f - static_cast<float>(level) * DYNAMIC_RESOLUTION_STEP;
+        DynamicResolution resolution;
+        resolution.setup(renderer, BENCH_WIDTH, BENCH_HEIGHT,
+                         BENCH_FRAME_BUDGET_MS);
+        // Reports far over budget walk the controller down to this level.
+        while (resolution.scale() > scale) {
+            resolution.update(BENCH_FRAME_BUDGET_MS * 10);
+        }
+
+        auto start = BenchClock::now();
+        for (int frame = 0; frame < BENCH_RESOLUTION_FRAMES; frame++) {
+            resolution.begin(renderer);
+            SDL_RenderClear(renderer);
+            commands.submit(renderer);
+            resolution.end(renderer);
+            SDL_RenderPresent(renderer);
+        }
+        double ms =
+            benchMs(start, BenchClock::now()) / BENCH_RESOLUTION_FRAMES;
+        std::cout << std::format("resolution: scale {:.0f}%, {} sprites, "
+                                 "{:.3f} ms per frame\n",
+                                 scale * 100, commands.size(), ms);
+    }
+}
+
+void benchResolution() {
+    BenchRenderer renderer;
+    benchResolutionController(renderer.get());
+    benchResolutionScales(renderer.get());
+}
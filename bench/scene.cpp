@@ -0,0 +1,88 @@
+#include "bench.h"
+#include <string>
+
+constexpr std::size_t BENCH_SCENE_ENTITIES = 10000;
+constexpr int BENCH_SCENE_ROUNDS = 20;
+constexpr int BENCH_SCENE_TICKS = 60;
+constexpr SDL_FPoint BENCH_SPRITE_SIZE = {120, 90};
+
+WorldSetup benchWorldSetup(std::size_t particle_capacity) {
+    Scene scene = loadScene(SCENE_PATH);
+    std::vector<SDL_FPoint> sizes(scene.assets.size(), BENCH_SPRITE_SIZE);
+    return {std::move(scene), std::move(sizes), particle_capacity};
+}
+
+std::string benchSceneText(std::size_t entities) {
+    std::string text = "window 800 600 \"Bench\"\n"
+                       "image logo images/Cpp-logo.png\n"
+                       "font freesans fonts/freesansbold.ttf\n"
+                       "text title freesans 80 255 255 255 \"SDL\"\n"
+                       "entity logo player 340 240 5 5\n";
+    Xoshiro256 gen{1};
+    for (std::size_t i = 0; i < entities; i++) {
+        text += std::format("entity {} bounce {:.1f} {:.1f} {:.2f} {:.2f}\n",
+                            i % 2 ? "title" : "logo", gen.uniform(0, 680),
+                            gen.uniform(0, 510), gen.uniform(-4, 4),
+                            gen.uniform(-4, 4));
+    }
+    return text;
+}
+
+static void benchSceneParse(BenchState &state) {
+    const std::string text = benchSceneText(BENCH_SCENE_ENTITIES);
+    state.setItems(BENCH_SCENE_ENTITIES);
+    while (state.keepRunning()) {
+        Scene scene = parseScene(text, "bench");
+        benchKeep(scene.entities.size());
+    }
+}
+
+// Bouncing entities stepped the way every tick of the game steps them,
+// with the edge bursts feeding the particle system.
+static void benchWorldUpdate(BenchState &state) {
+    Scene scene = parseScene(benchSceneText(BENCH_SCENE_ENTITIES), "bench");
+    std::vector<SDL_FPoint> sizes(scene.assets.size(), BENCH_SPRITE_SIZE);
+    World world{{std::move(scene), std::move(sizes), PARTICLE_CAPACITY}};
+    world.seed(1);
+    state.setItems(world.entities());
+    while (state.keepRunning()) {
+        WorldEvents events = world.update({0, 0, 0});
+        benchKeep(events.bounces);
+    }
+}
+
+static const BenchRegistration bench_scene_parse{"scene/parse_10k",
+                                                 benchSceneParse};
+static const BenchRegistration bench_world_update{"world/update_10k",
+                                                  benchWorldUpdate};
+
+// Builds a scene with thousands of bouncing entities in memory, then times
+// parsing it, building a world from it and stepping that world.
+void benchScene() {
+    std::string text = benchSceneText(BENCH_SCENE_ENTITIES);
+
+    Scene scene = parseScene(text, "bench");
+    auto start = BenchClock::now();
+    for (int round = 0; round < BENCH_SCENE_ROUNDS; round++) {
+        scene = parseScene(text, "bench");
+    }
+    double parse_ms = benchMs(start, BenchClock::now()) / BENCH_SCENE_ROUNDS;
+
+    std::vector<SDL_FPoint> sizes(scene.assets.size(), BENCH_SPRITE_SIZE);
+    WorldSetup setup{std::move(scene), std::move(sizes), PARTICLE_CAPACITY};
+    start = BenchClock::now();
+    World world{setup};
+    double build_ms = benchMs(start, BenchClock::now());
+
+    world.seed(1);
+    start = BenchClock::now();
+    for (int tick = 0; tick < BENCH_SCENE_TICKS; tick++) {
+        world.update({0, 0, 0});
+    }
+    double tick_ms = benchMs(start, BenchClock::now()) / BENCH_SCENE_TICKS;
+
+    std::cout << std::format("scene: {} entities, {} KB, parse {:.3f} ms, "
+                             "world {:.3f} ms, update {:.3f} ms/tick\n",
+                             world.entities(), text.size() / 1024, parse_ms,
+                             build_ms, tick_ms);
+}
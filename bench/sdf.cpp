@@ -0,0 +1,114 @@
+#include "bench.h"
+#include "sdf_font.h"
+#include <algorithm>
+
+constexpr int BENCH_SDF_LABELS = 1000;
+constexpr int BENCH_SDF_FRAMES = 60;
+constexpr float BENCH_SDF_MIN_SIZE = 12;
+constexpr float BENCH_SDF_MAX_SIZE = 160;
+constexpr const char *BENCH_SDF_TEXT = "Sound Effects";
+
+// Animates the size of 1000 labels every frame from one distance field,
+// against opening the font and rasterizing the label again for every new
+// size, which is what a scene text at a new size used to cost.
+void benchSdf() {
+    if (!TTF_Init()) {
+        auto error = std::format("Error initializing SDL_ttf: {}",
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    Scene scene = loadScene(SCENE_PATH);
+    auto font_asset = std::find_if(
+        scene.assets.begin(), scene.assets.end(),
+        [](const SceneAsset &asset) { return asset.kind == AssetKind::Font; });
+    if (font_asset == scene.assets.end()) {
+        throw std::runtime_error("Error creating Font: no font in scene");
+    }
+
+    BenchRenderer renderer;
+    SdfFont font;
+    auto start = BenchClock::now();
+    font.load(font_asset->path);
+    double first_ms = benchMs(start, BenchClock::now());
+    bool first_cached = font.cached();
+
+    start = BenchClock::now();
+    font.load(font_asset->path);
+    double cached_ms = benchMs(start, BenchClock::now());
+
+    start = BenchClock::now();
+    font.build(renderer.get());
+    double build_ms = benchMs(start, BenchClock::now());
+
+    auto labelSize = [](int index, int frame) {
+        float t = static_cast<float>((index * 13 + frame) % BENCH_SDF_FRAMES) /
+                  BENCH_SDF_FRAMES;
+        return BENCH_SDF_MIN_SIZE +
+               t * (BENCH_SDF_MAX_SIZE - BENCH_SDF_MIN_SIZE);
+    };
+
+    TextureAtlas atlas;
+    CommandBuffer commands{atlas};
+    start = BenchClock::now();
+    for (int frame = 0; frame < BENCH_SDF_FRAMES; frame++) {
+        commands.clear();
+        for (int i = 0; i < BENCH_SDF_LABELS; i++) {
+            float x = static_cast<float>(i % 20 * 40);
+            float y = static_cast<float>(i / 20 * 12);
+            font.record(commands, RenderLayer::Overlay, BENCH_SDF_TEXT, x, y,
+                        labelSize(i, frame), BENCH_COLOR);
+        }
+        commands.sort();
+        commands.submit(renderer.get());
+        SDL_RenderPresent(renderer.get());
+    }
+    double sdf_ms = benchMs(start, BenchClock::now());
+
+    // One label at every size the animation passes through.
+    std::size_t raster_bytes = 0;
+    start = BenchClock::now();
+    for (int frame = 0; frame < BENCH_SDF_FRAMES; frame++) {
+        std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> sized{
+            TTF_OpenFont(font_asset->path.c_str(), labelSize(0, frame)),
+            TTF_CloseFont};
+        if (!sized) {
+            auto error = std::format("Error creating Font: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surf{
+            TTF_RenderText_Blended(sized.get(), BENCH_SDF_TEXT, 0, BENCH_COLOR),
+            SDL_DestroySurface};
+        if (!surf) {
+            auto error =
+                std::format("Error rendering Text: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{
+            SDL_CreateTextureFromSurface(renderer.get(), surf.get()),
+            SDL_DestroyTexture};
+        if (!texture) {
+            auto error =
+                std::format("Error creating Texture: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        raster_bytes += static_cast<std::size_t>(surf->w) *
+                        static_cast<std::size_t>(surf->h) * 4;
+    }
+    double raster_ms = benchMs(start, BenchClock::now());
+
+    std::cout << std::format("sdf: first load {:.1f} ms ({}), cached load "
+                             "{:.2f} ms, build {:.2f} ms, {} KB field, {} KB "
+                             "textures\n",
+                             first_ms, first_cached ? "cached" : "generated",
+                             cached_ms, build_ms, font.atlasBytes() / 1024,
+                             font.textureBytes() / 1024);
+    std::cout << std::format("sdf: {} labels at animated sizes {:.3f} ms per "
+                             "frame, reopening and rasterizing {:.3f} ms per "
+                             "size ({} KB for {} sizes of one label)\n",
+                             BENCH_SDF_LABELS, sdf_ms / BENCH_SDF_FRAMES,
+                             raster_ms / BENCH_SDF_FRAMES, raster_bytes / 1024,
+                             BENCH_SDF_FRAMES);
+
+    TTF_Quit();
+}
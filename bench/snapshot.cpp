@@ -0,0 +1,48 @@
+#include "bench.h"
+
+constexpr std::size_t BENCH_SNAPSHOT_PARTICLES = 100000;
+constexpr int BENCH_SNAPSHOT_ROUNDS = 100;
+
+// Saves, hashes and loads a world holding 100k particles, the buffer is
+// reused between rounds the same way quicksaves reuse it.
+void benchSnapshot() {
+    const WorldSetup setup = benchWorldSetup(BENCH_SNAPSHOT_PARTICLES);
+    World world{setup};
+    world.seed(1);
+    int bursts = static_cast<int>(BENCH_SNAPSHOT_PARTICLES / PARTICLE_BURST);
+    world.update({0, bursts, 0});
+
+    std::vector<std::byte> buffer;
+    Uint64 hash = world.save(buffer);
+
+    auto start = BenchClock::now();
+    for (int round = 0; round < BENCH_SNAPSHOT_ROUNDS; round++) {
+        hash ^= world.save(buffer);
+    }
+    double save_ms = benchMs(start, BenchClock::now());
+
+    start = BenchClock::now();
+    for (int round = 0; round < BENCH_SNAPSHOT_ROUNDS; round++) {
+        hash ^= snapshotHash(buffer);
+    }
+    double hash_ms = benchMs(start, BenchClock::now());
+
+    World copy{setup};
+    start = BenchClock::now();
+    for (int round = 0; round < BENCH_SNAPSHOT_ROUNDS; round++) {
+        copy.load(buffer);
+    }
+    double load_ms = benchMs(start, BenchClock::now());
+
+    std::vector<std::byte> copy_buffer;
+    bool match = copy.save(copy_buffer) == world.save(buffer);
+
+    std::cout << std::format("snapshot: {} particles, {} bytes, save {:.3f} "
+                             "ms, hash {:.3f} ms, load {:.3f} ms, round trip "
+                             "{} ({:x})\n",
+                             world.particles().size(), buffer.size(),
+                             save_ms / BENCH_SNAPSHOT_ROUNDS,
+                             hash_ms / BENCH_SNAPSHOT_ROUNDS,
+                             load_ms / BENCH_SNAPSHOT_ROUNDS,
+                             match ? "matches" : "differs", hash);
+}
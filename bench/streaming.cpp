@@ -0,0 +1,143 @@
+#include "bench.h"
+#include "streaming_texture.h"
+#include <cmath>
+#include <numbers>
+
+constexpr int BENCH_STREAMING_FRAMES = 120;
+constexpr int BENCH_STREAMING_MAP_SIZE = 256;
+
+// The classic plasma, three sine waves summed and looked up in a palette,
+// cheap enough that the upload dominates.
+class Plasma {
+    public:
+        Plasma() : wave{}, palette{} {
+            for (std::size_t i = 0; i < this->wave.size(); i++) {
+                double angle =
+                    static_cast<double>(i) * 2 * std::numbers::pi / 256;
+                this->wave[i] = static_cast<Uint8>(
+                    std::lround(127.5 + 127.5 * std::sin(angle)));
+            }
+            for (std::size_t i = 0; i < this->palette.size(); i++) {
+                Uint32 r = this->wave[i];
+                Uint32 g = this->wave[(i + 85) & 0xFF];
+                Uint32 b = this->wave[(i + 170) & 0xFF];
+                this->palette[i] = 0xFF000000 | b << 16 | g << 8 | r;
+            }
+        }
+
+        void draw(const StreamingLock &lock, int frame) const {
+            this->draw(lock.rect, frame,
+                       [&lock](int y) { return lock.row(y); });
+        }
+
+        template <typename Row>
+        void draw(const SDL_Rect &rect, int frame, Row row) const {
+            for (int y = 0; y < rect.h; y++) {
+                Uint32 *pixels = row(y);
+                auto wy = this->wave[static_cast<Uint8>((rect.y + y) * 2 +
+                                                        frame)];
+                for (int x = 0; x < rect.w; x++) {
+                    int px = rect.x + x;
+                    auto index = static_cast<Uint8>(
+                        this->wave[static_cast<Uint8>(px + frame * 3)] + wy +
+                        this->wave[static_cast<Uint8>((px + rect.y + y) / 2)]);
+                    pixels[x] = this->palette[index];
+                }
+            }
+        }
+
+    private:
+        std::array<Uint8, 256> wave;
+        std::array<Uint32, 256> palette;
+};
+
+struct StreamingCase {
+        const char *name;
+        std::size_t buffers;
+        bool partial;
+};
+
+static void benchStreamingResult(const char *name, double ms, Uint64 bytes) {
+    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << std::format("streaming: {}, {:.3f} ms per frame, {:.0f} "
+                             "MB/s\n",
+                             name, ms / BENCH_STREAMING_FRAMES,
+                             ms > 0 ? mb / (ms / 1000.0) : 0);
+}
+
+// Full screen plasma frames uploaded the old way, generated into a surface
+// and copied with SDL_UpdateTexture, then written straight into locked
+// textures with one and two buffers. The partial case redraws a minimap
+// sized square that moves every frame.
+void benchStreaming() {
+    BenchRenderer renderer;
+    Plasma plasma;
+
+    {
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+            SDL_CreateSurface(BENCH_WIDTH, BENCH_HEIGHT,
+                              SDL_PIXELFORMAT_RGBA32),
+            SDL_DestroySurface};
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{
+            SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_RGBA32,
+                              SDL_TEXTUREACCESS_STREAMING, BENCH_WIDTH,
+                              BENCH_HEIGHT),
+            SDL_DestroyTexture};
+        if (!surface || !texture) {
+            auto error = std::format("Error creating streaming Texture: {}",
+                                     SDL_GetError());
+            throw std::runtime_error(error);
+        }
+
+        auto start = BenchClock::now();
+        for (int frame = 0; frame < BENCH_STREAMING_FRAMES; frame++) {
+            plasma.draw({0, 0, BENCH_WIDTH, BENCH_HEIGHT}, frame,
+                        [&surface](int y) {
+                            return reinterpret_cast<Uint32 *>(
+                                static_cast<Uint8 *>(surface->pixels) +
+                                y * surface->pitch);
+                        });
+            SDL_UpdateTexture(texture.get(), nullptr, surface->pixels,
+                              surface->pitch);
+            SDL_RenderTexture(renderer.get(), texture.get(), nullptr, nullptr);
+            SDL_RenderPresent(renderer.get());
+        }
+        double ms = benchMs(start, BenchClock::now());
+        benchStreamingResult("surface + SDL_UpdateTexture", ms,
+                             static_cast<Uint64>(BENCH_WIDTH) * BENCH_HEIGHT *
+                                 4 * BENCH_STREAMING_FRAMES);
+    }
+
+    constexpr std::array<StreamingCase, 3> cases = {{
+        {"locked, 1 buffer", 1, false},
+        {"locked, 2 buffers", 2, false},
+        {"locked partial, 2 buffers", 2, true},
+    }};
+    for (const StreamingCase &test : cases) {
+        StreamingTexture texture;
+        texture.setup(renderer.get(), BENCH_WIDTH, BENCH_HEIGHT, test.buffers);
+        // Both buffers start out whole, so the partial case only pays for
+        // the squares.
+        for (std::size_t i = 0; i < test.buffers; i++) {
+            plasma.draw(texture.lock(), 0);
+            texture.unlock();
+        }
+        Uint64 setup_bytes = texture.uploadedBytes();
+
+        auto start = BenchClock::now();
+        for (int frame = 0; frame < BENCH_STREAMING_FRAMES; frame++) {
+            SDL_Rect square{
+                frame * 4 % (BENCH_WIDTH - BENCH_STREAMING_MAP_SIZE),
+                frame * 2 % (BENCH_HEIGHT - BENCH_STREAMING_MAP_SIZE),
+                BENCH_STREAMING_MAP_SIZE, BENCH_STREAMING_MAP_SIZE};
+            plasma.draw(texture.lock(test.partial ? &square : nullptr), frame);
+            texture.unlock();
+            SDL_RenderTexture(renderer.get(), texture.texture(), nullptr,
+                              nullptr);
+            SDL_RenderPresent(renderer.get());
+        }
+        double ms = benchMs(start, BenchClock::now());
+        benchStreamingResult(test.name, ms,
+                             texture.uploadedBytes() - setup_bytes);
+    }
+}
@@ -0,0 +1,108 @@
+#include "bench.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct BenchEntry {
+        std::string name;
+        BenchFunction function;
+};
+
+struct BenchResult {
+        std::string name;
+        Uint64 iterations;
+        double ns;
+        double items_per_second;
+};
+
+// A function local list, registrations run during static initialization
+// in whatever order the files are linked.
+static std::vector<BenchEntry> &benchRegistry() {
+    static std::vector<BenchEntry> registry;
+    return registry;
+}
+
+void benchRegister(const char *name, BenchFunction function) {
+    benchRegistry().push_back({name, function});
+}
+
+// Starts with one iteration and grows the count from the time the last run
+// took until a run lasts BENCH_MIN_TIME_MS, aiming a bit past it so the
+// final run rarely falls short.
+static BenchResult benchRun(const BenchEntry &entry) {
+    Uint64 iterations = 1;
+    while (true) {
+        BenchState state{iterations};
+        entry.function(state);
+        double ms = state.ms();
+
+        if (ms >= BENCH_MIN_TIME_MS || iterations >= BENCH_MAX_ITERATIONS) {
+            double seconds = ms / 1000.0;
+            double items = static_cast<double>(state.itemCount()) *
+                           static_cast<double>(iterations);
+            return {entry.name, iterations,
+                    ms * 1e6 / static_cast<double>(iterations),
+                    seconds > 0 ? items / seconds : 0};
+        }
+
+        double scale = ms > 0 ? BENCH_MIN_TIME_MS * 1.4 / ms : 10;
+        scale = std::clamp(scale, 2.0, 10.0);
+        iterations = std::min(
+            BENCH_MAX_ITERATIONS,
+            static_cast<Uint64>(static_cast<double>(iterations) * scale));
+    }
+}
+
+// Uses the key names of Google Benchmark's JSON output, so its compare.py
+// can diff two result files from different commits.
+static void benchWriteJson(const char *path,
+                           const std::vector<BenchResult> &results) {
+    std::string json = std::format(
+        "{{\n  \"context\": {{\n    \"num_cpus\": {},\n"
+        "    \"min_time_ms\": {:.0f}\n  }},\n  \"benchmarks\": [",
+        SDL_GetNumLogicalCPUCores(), BENCH_MIN_TIME_MS);
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        json += std::format(
+            "{}\n    {{\"name\": \"{}\", \"run_type\": \"iteration\", "
+            "\"iterations\": {}, \"real_time\": {:.3f}, \"cpu_time\": "
+            "{:.3f}, \"time_unit\": \"ns\", \"items_per_second\": {:.1f}}}",
+            i > 0 ? "," : "", result.name, result.iterations, result.ns,
+            result.ns, result.items_per_second);
+    }
+    json += "\n  ]\n}\n";
+
+    if (!SDL_SaveFile(path, json.data(), json.size())) {
+        auto error =
+            std::format("Error saving bench results: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+}
+
+void benchRunSuite(std::string_view filter, const char *json_path) {
+    std::vector<BenchEntry> entries = benchRegistry();
+    std::sort(entries.begin(), entries.end(),
+              [](const BenchEntry &a, const BenchEntry &b) {
+                  return a.name < b.name;
+              });
+
+    std::vector<BenchResult> results;
+    std::cout << std::format("{:<32} {:>14} {:>12} {:>14}\n", "benchmark",
+                             "time", "iterations", "items/s");
+    for (const BenchEntry &entry : entries) {
+        if (entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        BenchResult result = benchRun(entry);
+        std::cout << std::format("{:<32} {:>11.1f} ns {:>12} {:>14.0f}\n",
+                                 result.name, result.ns, result.iterations,
+                                 result.items_per_second);
+        results.push_back(std::move(result));
+    }
+
+    if (json_path) {
+        benchWriteJson(json_path, results);
+        std::cout << std::format("Wrote {} results to {}\n", results.size(),
+                                 json_path);
+    }
+}
@@ -0,0 +1,122 @@
+#include "bench.h"
+#include "text_cache.h"
+#include <algorithm>
+
+constexpr int BENCH_TEXT_LABELS = 1000;
+constexpr int BENCH_TEXT_VALUES = 200;
+constexpr int BENCH_TEXT_FRAMES = 60;
+constexpr float BENCH_TEXT_SIZE = 18;
+
+std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> benchFont(float size) {
+    std::string path = benchAssetPath(AssetKind::Font);
+    std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> font{
+        TTF_OpenFont(path.c_str(), size), TTF_CloseFont};
+    if (!font) {
+        auto error = std::format("Error creating Font: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return font;
+}
+
+// One HUD sized label per iteration, cycling through values that are all
+// in the cache after the first round.
+static void benchTextCacheDraw(BenchState &state) {
+    auto font = benchFont(BENCH_TEXT_SIZE);
+    BenchRenderer renderer;
+    TextCache cache;
+    cache.setup(renderer.get(), font.get());
+
+    std::array<char, 32> line;
+    int value = 0;
+    state.setItems(1);
+    while (state.keepRunning()) {
+        auto result = std::format_to_n(line.data(), line.size(), "hp {}",
+                                       value);
+        std::size_t length =
+            std::min(static_cast<std::size_t>(result.size), line.size());
+        cache.draw({line.data(), length}, 0, 0, BENCH_COLOR);
+        value = (value + 1) % BENCH_TEXT_VALUES;
+    }
+    cache.reset();
+}
+
+static const BenchRegistration bench_text_cache_draw{"text/cache_draw",
+                                                     benchTextCacheDraw};
+
+// Draws 1000 labels whose values change every frame but repeat, like
+// health bars or score popups, through the text cache and by rendering
+// each label to a new surface and texture.
+void benchText() {
+    auto font = benchFont(BENCH_TEXT_SIZE);
+    BenchRenderer renderer;
+    std::array<char, 32> line;
+    auto label = [&line](int index, int frame) {
+        int value = (index * 7 + frame) % BENCH_TEXT_VALUES;
+        auto result = std::format_to_n(line.data(), line.size(), "hp {}",
+                                       value);
+        std::size_t length =
+            std::min(static_cast<std::size_t>(result.size), line.size());
+        return std::string_view{line.data(), length};
+    };
+    auto labelPos = [](int index) {
+        return SDL_FPoint{static_cast<float>(index % 20 * 40),
+                          static_cast<float>(index / 20 * 12)};
+    };
+
+    double naive_ms = 0;
+    {
+        auto start = BenchClock::now();
+        for (int frame = 0; frame < BENCH_TEXT_FRAMES; frame++) {
+            for (int i = 0; i < BENCH_TEXT_LABELS; i++) {
+                std::string_view str = label(i, frame);
+                SDL_Surface *surf = TTF_RenderText_Blended(
+                    font.get(), str.data(), str.size(), BENCH_COLOR);
+                if (!surf) {
+                    auto error = std::format("Error rendering Text: {}",
+                                             SDL_GetError());
+                    throw std::runtime_error(error);
+                }
+                SDL_Texture *texture =
+                    SDL_CreateTextureFromSurface(renderer.get(), surf);
+                SDL_DestroySurface(surf);
+                if (!texture) {
+                    auto error = std::format("Error creating Texture: {}",
+                                             SDL_GetError());
+                    throw std::runtime_error(error);
+                }
+                SDL_FPoint pos = labelPos(i);
+                SDL_FRect rect = {pos.x, pos.y,
+                                  static_cast<float>(texture->w),
+                                  static_cast<float>(texture->h)};
+                SDL_RenderTexture(renderer.get(), texture, nullptr, &rect);
+                SDL_DestroyTexture(texture);
+            }
+            SDL_RenderPresent(renderer.get());
+        }
+        naive_ms = benchMs(start, BenchClock::now());
+    }
+
+    TextCache cache;
+    cache.setup(renderer.get(), font.get());
+    auto start = BenchClock::now();
+    for (int frame = 0; frame < BENCH_TEXT_FRAMES; frame++) {
+        for (int i = 0; i < BENCH_TEXT_LABELS; i++) {
+            SDL_FPoint pos = labelPos(i);
+            cache.draw(label(i, frame), pos.x, pos.y, BENCH_COLOR);
+        }
+        SDL_RenderPresent(renderer.get());
+    }
+    double cached_ms = benchMs(start, BenchClock::now());
+
+    TextCacheStats stats = cache.stats();
+    double lookups = static_cast<double>(stats.hits + stats.misses);
+    std::cout << std::format("text: {} labels, naive {:.3f} ms, cached {:.3f} "
+                             "ms per frame, {} entries, hit rate {:.1f}%, "
+                             "{} evictions\n",
+                             BENCH_TEXT_LABELS, naive_ms / BENCH_TEXT_FRAMES,
+                             cached_ms / BENCH_TEXT_FRAMES, cache.size(),
+                             100.0 * static_cast<double>(stats.hits) / lookups,
+                             stats.evictions);
+
+    cache.reset();
+}
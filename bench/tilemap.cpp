@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "tilemap.h"
+
+constexpr int BENCH_TILEMAP_FRAMES = 200;
+constexpr int BENCH_TILESET_TILES = 8;
+constexpr int BENCH_TILEMAP_SIZES[] = {64, 512, 2048};
+
+static std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>
+createTileset() {
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+        SDL_CreateSurface(TILE_SIZE * BENCH_TILESET_TILES, TILE_SIZE,
+                          SDL_PIXELFORMAT_RGBA32),
+        SDL_DestroySurface};
+    if (!surface) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    for (int i = 0; i < BENCH_TILESET_TILES; i++) {
+        SDL_Rect rect = {i * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE};
+        Uint32 shade = static_cast<Uint32>(i * 255 / BENCH_TILESET_TILES);
+        SDL_FillSurfaceRect(surface.get(), &rect,
+                            0xFF000000 | shade << 16 | shade << 8 | shade);
+    }
+
+    return surface;
+}
+
+void benchTilemap() {
+    BenchRenderer renderer;
+    TextureAtlas atlas;
+    auto tileset_surf = createTileset();
+    const AtlasRegion &tileset = atlas.add("tileset", tileset_surf.get());
+    atlas.build(renderer.get());
+
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<int> rand_tile{0, BENCH_TILESET_TILES};
+
+    TilemapVertices vertices;
+    CommandBuffer commands{atlas};
+
+    for (int size : BENCH_TILEMAP_SIZES) {
+        Tilemap map{atlas, tileset, size, size};
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                map.setTile(x, y, static_cast<Uint16>(rand_tile(gen)));
+            }
+        }
+
+        Camera camera{BENCH_WIDTH, BENCH_HEIGHT};
+        float camera_x = map.width() / 2;
+        float camera_y = map.height() / 2;
+        double draw_ms = 0;
+        double edit_ms = 0;
+
+        for (int frame = 0; frame < BENCH_TILEMAP_FRAMES; frame++) {
+            // Scroll one pixel per frame and edit one visible tile so the
+            // steady state includes a single dirty chunk rebuild.
+            camera_x += 1;
+            camera.centerOn(camera_x, camera_y);
+            int tile_x = static_cast<int>(camera_x) / TILE_SIZE;
+            int tile_y = static_cast<int>(camera_y) / TILE_SIZE;
+
+            auto start = BenchClock::now();
+            map.setTile(tile_x, tile_y, static_cast<Uint16>(frame % 2 + 1));
+            SDL_RenderClear(renderer.get());
+            commands.clear();
+            map.batch(camera, vertices);
+            map.record(commands, vertices);
+            commands.sort();
+            commands.submit(renderer.get());
+            SDL_RenderPresent(renderer.get());
+            auto end = BenchClock::now();
+
+            if (frame == 0) {
+                // The first frame builds every visible chunk from scratch.
+                edit_ms = benchMs(start, end);
+            } else {
+                draw_ms += benchMs(start, end);
+            }
+        }
+
+        draw_ms /= BENCH_TILEMAP_FRAMES - 1;
+        const TilemapStats &stats = vertices.stats;
+        std::cout << std::format("tilemap: {}x{} tiles, first frame {:.3f} ms, "
+                                 "frame {:.3f} ms, chunks drawn {}, culled {}, "
+                                 "tiles drawn {}\n",
+                                 size, size, edit_ms, draw_ms,
+                                 stats.chunks_drawn, stats.chunks_culled,
+                                 stats.tiles_drawn);
+    }
+}
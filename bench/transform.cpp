@@ -0,0 +1,119 @@
+#include "bench.h"
+#include "command_buffer.h"
+
+constexpr int BENCH_TRANSFORM_SPRITES = 20000;
+constexpr int BENCH_TRANSFORM_FRAMES = 20;
+constexpr int BENCH_TRANSFORM_SPRITE_SIZE = 32;
+
+struct BenchTransformed {
+        SDL_FRect rect;
+        SpriteTransform transform;
+};
+
+// Turned, scaled and tinted sprites drawn the way Game::draw did before the
+// transforms went into the vertices, one color mod, one alpha mod and one
+// rotated copy each.
+static double
+benchTransformRotated(SDL_Renderer *renderer, const TextureAtlas &atlas,
+                      const AtlasRegion &region,
+                      const std::vector<BenchTransformed> &sprites) {
+    SDL_Texture *texture = atlas.texture(region.page);
+
+    auto start = BenchClock::now();
+    for (int frame = 0; frame < BENCH_TRANSFORM_FRAMES; frame++) {
+        SDL_RenderClear(renderer);
+        for (const BenchTransformed &sprite : sprites) {
+            const SDL_FColor &tint = sprite.transform.tint;
+            SDL_SetTextureColorMod(texture, static_cast<Uint8>(tint.r * 255),
+                                   static_cast<Uint8>(tint.g * 255),
+                                   static_cast<Uint8>(tint.b * 255));
+            SDL_SetTextureAlphaMod(texture, static_cast<Uint8>(tint.a * 255));
+
+            float w = sprite.rect.w * sprite.transform.scale;
+            float h = sprite.rect.h * sprite.transform.scale;
+            SDL_FRect dst{sprite.rect.x + (sprite.rect.w - w) / 2,
+                          sprite.rect.y + (sprite.rect.h - h) / 2, w, h};
+            SDL_RenderTextureRotated(renderer, texture, &region.rect, &dst,
+                                     sprite.transform.angle, nullptr,
+                                     SDL_FLIP_NONE);
+        }
+        SDL_RenderPresent(renderer);
+    }
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    return benchMs(start, BenchClock::now()) / BENCH_TRANSFORM_FRAMES;
+}
+
+// Draws the same sprites once with the old state change and rotated copy per
+// sprite and once through the command buffer, where the corners are
+// transformed on the CPU and everything goes out as a single batch. Plain
+// sprites are recorded as well to show what the transform costs.
+void benchTransform() {
+    BenchRenderer renderer;
+    TextureAtlas atlas;
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+        SDL_CreateSurface(BENCH_TRANSFORM_SPRITE_SIZE,
+                          BENCH_TRANSFORM_SPRITE_SIZE, SDL_PIXELFORMAT_RGBA32),
+        SDL_DestroySurface};
+    if (!surface) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    SDL_FillSurfaceRect(surface.get(), nullptr, 0xFFFFFFFF);
+    AtlasRegion region = atlas.add("sprite", surface.get());
+    atlas.build(renderer.get());
+
+    Xoshiro256 gen{1};
+    std::vector<BenchTransformed> sprites(BENCH_TRANSFORM_SPRITES);
+    for (BenchTransformed &sprite : sprites) {
+        sprite.rect = {gen.uniform(0, BENCH_WIDTH),
+                       gen.uniform(0, BENCH_HEIGHT),
+                       BENCH_TRANSFORM_SPRITE_SIZE,
+                       BENCH_TRANSFORM_SPRITE_SIZE};
+        sprite.transform = {gen.uniform(0, 360),
+                            gen.uniform(0.5f, 2),
+                            {gen.uniform(0, 1), gen.uniform(0, 1),
+                             gen.uniform(0, 1), 1}};
+    }
+
+    double rotated_ms =
+        benchTransformRotated(renderer.get(), atlas, region, sprites);
+
+    CommandBuffer commands{atlas};
+    double plain_ms = 0;
+    double record_ms = 0;
+    double submit_ms = 0;
+    for (int frame = 0; frame < BENCH_TRANSFORM_FRAMES; frame++) {
+        auto start = BenchClock::now();
+        commands.clear();
+        for (const BenchTransformed &sprite : sprites) {
+            commands.add(RenderLayer::Sprites, region, sprite.rect);
+        }
+        auto plain = BenchClock::now();
+
+        commands.clear();
+        for (const BenchTransformed &sprite : sprites) {
+            commands.add(RenderLayer::Sprites, region, sprite.rect,
+                         sprite.transform);
+        }
+        auto recorded = BenchClock::now();
+
+        commands.sort();
+        SDL_RenderClear(renderer.get());
+        commands.submit(renderer.get());
+        SDL_RenderPresent(renderer.get());
+        auto submitted = BenchClock::now();
+
+        plain_ms += benchMs(start, plain);
+        record_ms += benchMs(plain, recorded);
+        submit_ms += benchMs(recorded, submitted);
+    }
+
+    std::cout << std::format(
+        "transform: {} sprites, rotated copies {:.3f} ms in {} calls, "
+        "batched record {:.3f} ms (plain {:.3f} ms), sort and submit "
+        "{:.3f} ms in {} batches\n",
+        sprites.size(), rotated_ms, sprites.size() * 3,
+        record_ms / BENCH_TRANSFORM_FRAMES, plain_ms / BENCH_TRANSFORM_FRAMES,
+        submit_ms / BENCH_TRANSFORM_FRAMES, commands.batches());
+}
@@ -0,0 +1,20 @@
+#include "bench.h"
+#include "headless.h"
+
+constexpr std::size_t BENCH_WORLDS = 32;
+constexpr Uint64 BENCH_WORLD_TICKS = 600;
+
+void benchWorlds() {
+    const WorldSetup setup = benchWorldSetup(PARTICLE_CAPACITY);
+    std::size_t cores = static_cast<std::size_t>(
+        std::max(1, SDL_GetNumLogicalCPUCores()));
+
+    for (std::size_t threads = 1; threads <= cores; threads *= 2) {
+        HeadlessResult result =
+            runHeadless(setup, BENCH_WORLDS, threads, BENCH_WORLD_TICKS);
+        std::cout << std::format("worlds: {} worlds, {} threads, {:.0f} "
+                                 "ticks/s\n",
+                                 result.worlds, result.threads,
+                                 result.ticks_per_second);
+    }
+}
@@ -0,0 +1,162 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+
+AnimationPlayer::AnimationPlayer()
+    : time{},
+      speed{},
+      duration{},
+      fps{},
+      last{},
+      first{},
+      frame_index{} {}
+
+Uint32 AnimationPlayer::add(const AnimationClip &clip, float clip_speed,
+                            float start_time) {
+    auto instance = static_cast<Uint32>(this->time.size());
+    float clip_duration = static_cast<float>(clip.frames) / clip.fps;
+
+    this->time.push_back(std::clamp(start_time, 0.0f, clip_duration));
+    this->speed.push_back(clip_speed);
+    this->duration.push_back(clip_duration);
+    this->fps.push_back(clip.fps);
+    this->last.push_back(static_cast<float>(clip.frames - 1));
+    this->first.push_back(clip.first);
+    this->frame_index.push_back(clip.first);
+    return instance;
+}
+
+static Uint32 frameAt(float time, float fps, float last, Uint32 first) {
+    float local = std::min(time * fps, last);
+    return first + static_cast<Uint32>(static_cast<int>(local));
+}
+
+// Wrapping is two selects rather than a modulo, which keeps the loop free
+// of calls and branches. Both candidates are computed up front, a float
+// operation that only happens on one side of a condition is a branch to
+// the vectorizer. The min() catches a time that rounds to exactly the clip
+// length. Whether any time is still outside its clip is or-ed together
+// without a branch and handled once after the loop.
+void AnimationPlayer::update(float dt) {
+    const std::size_t count = this->time.size();
+    float *times = this->time.data();
+    const float *speeds = this->speed.data();
+    const float *durations = this->duration.data();
+    const float *rates = this->fps.data();
+    const float *lasts = this->last.data();
+    const Uint32 *firsts = this->first.data();
+    Uint32 *frames = this->frame_index.data();
+    bool outside = false;
+
+    for (std::size_t i = 0; i < count; i++) {
+        float t = times[i] + dt * speeds[i];
+        float over = t - durations[i];
+        float under = t + durations[i];
+        t = over >= 0 ? over : t;
+        t = t < 0 ? under : t;
+        times[i] = t;
+        outside |= (t < 0) | (t >= durations[i]);
+
+        frames[i] = frameAt(t, rates[i], lasts[i], firsts[i]);
+    }
+
+    if (outside) {
+        this->rewrap();
+    }
+}
+
+// fmod for the instances that moved more than a clip length in one step,
+// which would otherwise sit on their last frame for good.
+void AnimationPlayer::rewrap() {
+    for (std::size_t i = 0; i < this->time.size(); i++) {
+        float t = this->time[i];
+        const float clip_duration = this->duration[i];
+        if (t >= 0 && t < clip_duration) {
+            continue;
+        }
+
+        t = std::fmod(t, clip_duration);
+        t = t < 0 ? t + clip_duration : t;
+        this->time[i] = t;
+        this->frame_index[i] =
+            frameAt(t, this->fps[i], this->last[i], this->first[i]);
+    }
+}
+
+void AnimationPlayer::clear() {
+    for (std::vector<float> *array : {&this->time, &this->speed,
+                                      &this->duration, &this->fps,
+                                      &this->last}) {
+        array->clear();
+    }
+    this->first.clear();
+    this->frame_index.clear();
+}
+
+// Clips and speeds come from the scene, only the playback times move.
+void AnimationPlayer::save(SnapshotWriter &writer) const {
+    writer.writeArray(this->time.data(), this->time.size());
+}
+
+void AnimationPlayer::load(SnapshotReader &reader) {
+    reader.readArray(this->time.data(), this->time.size());
+    this->update(0);
+}
+
+// Moves past what load() would read, so a snapshot can be validated
+// without changing the player.
+void AnimationPlayer::check(SnapshotReader &reader) const {
+    reader.skip<float>(this->time.size());
+}
+
+std::vector<AnimationClip> animationClips(const Scene &scene) {
+    std::vector<AnimationClip> clips;
+    Uint32 first = 0;
+    for (const SceneAnimation &animation : scene.animations) {
+        clips.push_back({first, animation.frames, animation.fps});
+        first += animation.frames;
+    }
+    return clips;
+}
+
+std::vector<AtlasRegion> bakeAnimationFrames(const Scene &scene,
+                                             const TextureAtlas &atlas) {
+    std::vector<AtlasRegion> frames;
+
+    for (const SceneAnimation &animation : scene.animations) {
+        const SceneAsset &image = scene.assets[animation.image];
+        const AtlasRegion &sheet = atlas.region(image.name);
+        int columns = static_cast<int>(sheet.rect.w) / animation.frame_w;
+        int rows = static_cast<int>(sheet.rect.h) / animation.frame_h;
+        if (static_cast<Uint64>(columns) * static_cast<Uint64>(rows) <
+            animation.frames) {
+            auto error = std::format(
+                "Error animation {} has {} frames, image {} holds {}",
+                scene.assets[animation.asset].name, animation.frames,
+                image.name, columns * rows);
+            throw std::runtime_error(error);
+        }
+
+        for (Uint32 i = 0; i < animation.frames; i++) {
+            int column = static_cast<int>(i) % columns;
+            int row = static_cast<int>(i) / columns;
+            SDL_FRect rect{
+                sheet.rect.x + static_cast<float>(column * animation.frame_w),
+                sheet.rect.y + static_cast<float>(row * animation.frame_h),
+                static_cast<float>(animation.frame_w),
+                static_cast<float>(animation.frame_h)};
+            // Scaled from the sheet's own uv, a sheet too large for a shared
+            // page sits on one sized to fit it.
+            float u_scale = sheet.uv.w / sheet.rect.w;
+            float v_scale = sheet.uv.h / sheet.rect.h;
+            frames.push_back(
+                {sheet.page,
+                 rect,
+                 {sheet.uv.x + (rect.x - sheet.rect.x) * u_scale,
+                  sheet.uv.y + (rect.y - sheet.rect.y) * v_scale,
+                  rect.w * u_scale, rect.h * v_scale}});
+        }
+    }
+
+    return frames;
+}
@@ -0,0 +1,65 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "atlas.h"
+#include "scene.h"
+#include "snapshot.h"
+#include <vector>
+
+constexpr Uint32 ANIMATION_NONE = static_cast<Uint32>(-1);
+
+// A run of frames in the baked frame table, played at fps and looped.
+struct AnimationClip {
+        Uint32 first;
+        Uint32 frames;
+        float fps;
+};
+
+// Playback state of many animations at once as structure-of-arrays. The
+// clip is copied into every instance instead of being looked up, so
+// update() is one branch free loop over contiguous arrays that the compiler
+// vectorizes. The result is an index into the frame table that the clips
+// point into.
+//
+// The loop wraps a step of up to one clip length. A longer step, from a
+// clip shorter than a tick or a high speed, is caught after the loop and
+// wrapped again on a slower path.
+class AnimationPlayer {
+    public:
+        AnimationPlayer();
+
+        Uint32 add(const AnimationClip &clip, float speed = 1,
+                   float time = 0);
+        void update(float dt);
+        void clear();
+        void save(SnapshotWriter &writer) const;
+        void load(SnapshotReader &reader);
+        void check(SnapshotReader &reader) const;
+
+        std::size_t size() const { return this->time.size(); }
+        Uint32 frame(std::size_t instance) const {
+            return this->frame_index[instance];
+        }
+
+    private:
+        void rewrap();
+
+        std::vector<float> time;
+        std::vector<float> speed;
+        std::vector<float> duration;
+        std::vector<float> fps;
+        std::vector<float> last;
+        std::vector<Uint32> first;
+        std::vector<Uint32> frame_index;
+};
+
+// One clip per scene animation in scene order, each starting where the
+// frames of the previous one end.
+std::vector<AnimationClip> animationClips(const Scene &scene);
+
+// The frame table for those clips. Frames are cut from the animation's
+// image left to right and top to bottom, every clip's frames back to back.
+std::vector<AtlasRegion> bakeAnimationFrames(const Scene &scene,
+                                             const TextureAtlas &atlas);
+
+#endif
@@ -0,0 +1,141 @@
+#include "asset_watcher.h"
+#include <algorithm>
+
+#ifdef SDL_PLATFORM_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+AssetWatcher::AssetWatcher()
+    : directories{},
+      modified{},
+      mutex{},
+      pending{},
+      worker{} {}
+
+AssetWatcher::~AssetWatcher() {
+    if (this->worker.joinable()) {
+        this->worker.request_stop();
+        this->worker.join();
+    }
+}
+
+void AssetWatcher::start(const std::vector<std::string> &watch_dirs) {
+    this->directories = watch_dirs;
+    this->worker = std::jthread{
+        [this](std::stop_token stop) { this->watch(stop); }};
+}
+
+void AssetWatcher::changed(std::string path) {
+    std::lock_guard lock{this->mutex};
+    if (std::find(this->pending.begin(), this->pending.end(), path) ==
+        this->pending.end()) {
+        this->pending.push_back(std::move(path));
+    }
+}
+
+#ifdef SDL_PLATFORM_LINUX
+
+// poll() with a short timeout lets the thread notice a stop request without
+// a wakeup pipe. The watch descriptors are tiny so a linear lookup is fine.
+void AssetWatcher::watch(std::stop_token stop) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        this->scan(stop);
+        return;
+    }
+
+    std::vector<std::pair<int, std::string>> watches;
+    for (const std::string &directory : this->directories) {
+        int wd = inotify_add_watch(fd, directory.c_str(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd >= 0) {
+            watches.emplace_back(wd, directory);
+        } else {
+            std::cerr << std::format("Error watching {}", directory)
+                      << std::endl;
+        }
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    pollfd target{fd, POLLIN, 0};
+
+    while (!stop.stop_requested()) {
+        if (poll(&target, 1, ASSET_WATCH_POLL_MS) <= 0) {
+            continue;
+        }
+
+        ssize_t length = 0;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char *ptr = buffer; ptr < buffer + length;) {
+                const inotify_event *event =
+                    reinterpret_cast<const inotify_event *>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->len == 0) {
+                    continue;
+                }
+                for (const auto &[wd, directory] : watches) {
+                    if (wd == event->wd) {
+                        this->changed(directory + "/" + event->name);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    close(fd);
+}
+
+#else
+
+void AssetWatcher::watch(std::stop_token stop) { this->scan(stop); }
+
+#endif
+
+// Fallback for platforms without inotify. The first pass only records the
+// current modification times.
+void AssetWatcher::scan(std::stop_token stop) {
+    for (const std::string &directory : this->directories) {
+        this->scanDirectory(directory, false);
+    }
+
+    while (!stop.stop_requested()) {
+        for (int waited = 0; waited < ASSET_SCAN_MS && !stop.stop_requested();
+             waited += ASSET_WATCH_POLL_MS) {
+            SDL_Delay(ASSET_WATCH_POLL_MS);
+        }
+        for (const std::string &directory : this->directories) {
+            this->scanDirectory(directory, true);
+        }
+    }
+}
+
+void AssetWatcher::scanDirectory(const std::string &directory, bool report) {
+    int count = 0;
+    std::unique_ptr<char *, decltype(&SDL_free)> files{
+        SDL_GlobDirectory(directory.c_str(), nullptr, 0, &count), SDL_free};
+    if (!files) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        std::string path = directory + "/" + files.get()[i];
+        SDL_PathInfo info;
+        if (!SDL_GetPathInfo(path.c_str(), &info) ||
+            info.type != SDL_PATHTYPE_FILE) {
+            continue;
+        }
+
+        auto [it, inserted] =
+            this->modified.try_emplace(path, info.modify_time);
+        if (inserted || it->second != info.modify_time) {
+            it->second = info.modify_time;
+            if (report) {
+                this->changed(path);
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef ASSET_WATCHER_H
+#define ASSET_WATCHER_H
+
+#include "main.h"
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+constexpr int ASSET_WATCH_POLL_MS = 100;
+constexpr int ASSET_SCAN_MS = 500;
+
+// Watches asset directories on a background thread and collects the paths
+// of files that were written. On Linux this uses inotify and wakes only
+// when a file is closed after writing or renamed into place, which is how
+// most editors save. Elsewhere it rescans the directories and compares
+// modification times. The owner collects changes with takeChanged() at a
+// point where swapping the asset is safe.
+class AssetWatcher {
+    public:
+        AssetWatcher();
+        ~AssetWatcher();
+
+        AssetWatcher(const AssetWatcher &) = delete;
+        AssetWatcher &operator=(const AssetWatcher &) = delete;
+
+        void start(const std::vector<std::string> &watch_dirs);
+
+        // Removes and returns the changed paths that wanted accepts, each
+        // path once however often it was written, as "directory/file".
+        template <typename Filter>
+        std::vector<std::string> takeChanged(Filter wanted) {
+            std::vector<std::string> taken;
+
+            std::lock_guard lock{this->mutex};
+            for (const std::string &path : this->pending) {
+                if (wanted(path)) {
+                    taken.push_back(path);
+                }
+            }
+            std::erase_if(this->pending, wanted);
+
+            return taken;
+        }
+
+    private:
+        void watch(std::stop_token stop);
+        void scan(std::stop_token stop);
+        void scanDirectory(const std::string &directory, bool report);
+        void changed(std::string path);
+
+        std::vector<std::string> directories;
+        std::unordered_map<std::string, SDL_Time> modified;
+
+        std::mutex mutex;
+        std::vector<std::string> pending;
+
+        std::jthread worker;
+};
+
+#endif
@@ -0,0 +1,230 @@
+#include "atlas.h"
+#include "blit.h"
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(int page_width, int page_height)
+    : width{page_width},
+      height{page_height},
+      skyline{{0, 0, page_width}} {}
+
+int SkylinePacker::fit(std::size_t index, int w, int h) const {
+    int x = this->skyline[index].x;
+    if (x + w > this->width) {
+        return -1;
+    }
+
+    int y = 0;
+    int width_left = w;
+    for (std::size_t i = index; width_left > 0; i++) {
+        y = std::max(y, this->skyline[i].y);
+        if (y + h > this->height) {
+            return -1;
+        }
+        width_left -= this->skyline[i].w;
+    }
+
+    return y;
+}
+
+bool SkylinePacker::pack(int w, int h, SDL_Rect &rect) {
+    int best_top = std::numeric_limits<int>::max();
+    int best_width = std::numeric_limits<int>::max();
+    std::size_t best_index = this->skyline.size();
+
+    for (std::size_t i = 0; i < this->skyline.size(); i++) {
+        int y = this->fit(i, w, h);
+        if (y < 0) {
+            continue;
+        }
+        if (y + h < best_top ||
+            (y + h == best_top && this->skyline[i].w < best_width)) {
+            best_top = y + h;
+            best_width = this->skyline[i].w;
+            best_index = i;
+            rect = {this->skyline[i].x, y, w, h};
+        }
+    }
+
+    if (best_index == this->skyline.size()) {
+        return false;
+    }
+
+    this->insert(best_index, rect);
+    return true;
+}
+
+void SkylinePacker::insert(std::size_t index, const SDL_Rect &rect) {
+    this->skyline.insert(this->skyline.begin() + static_cast<long>(index),
+                         {rect.x, rect.y + rect.h, rect.w});
+
+    // Trim or remove the spans now covered by the new node.
+    for (std::size_t i = index + 1; i < this->skyline.size();) {
+        Node &prev = this->skyline[i - 1];
+        Node &node = this->skyline[i];
+        int overlap = prev.x + prev.w - node.x;
+        if (overlap <= 0) {
+            break;
+        }
+        if (node.w > overlap) {
+            node.x += overlap;
+            node.w -= overlap;
+            break;
+        }
+        this->skyline.erase(this->skyline.begin() + static_cast<long>(i));
+    }
+
+    // Merge neighbours left at the same height.
+    for (std::size_t i = 0; i + 1 < this->skyline.size();) {
+        if (this->skyline[i].y == this->skyline[i + 1].y) {
+            this->skyline[i].w += this->skyline[i + 1].w;
+            this->skyline.erase(this->skyline.begin() +
+                                static_cast<long>(i + 1));
+        } else {
+            i++;
+        }
+    }
+}
+
+TextureAtlas::TextureAtlas(int size) : page_size{size} {}
+
+void TextureAtlas::addPage(int width, int height) {
+    Page page{SkylinePacker{width, height},
+              {SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32),
+               SDL_DestroySurface},
+              {nullptr, SDL_DestroyTexture}};
+    if (!page.surface) {
+        auto error =
+            std::format("Error creating atlas Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->page_list.push_back(std::move(page));
+}
+
+// An image too large for a shared page gets a page of its own sized to fit
+// it. It fills that page, so later images never pack next to it, and it is
+// drawn like any other region.
+const AtlasRegion &TextureAtlas::add(const std::string &name,
+                                     SDL_Surface *surface) {
+    int w = surface->w + ATLAS_PADDING;
+    int h = surface->h + ATLAS_PADDING;
+    bool oversized = w > this->page_size || h > this->page_size;
+
+    SDL_Rect rect;
+    std::size_t page = oversized ? this->page_list.size() : 0;
+    while (page < this->page_list.size() &&
+           !this->page_list[page].packer.pack(w, h, rect)) {
+        page++;
+    }
+    if (page == this->page_list.size()) {
+        this->addPage(oversized ? w : this->page_size,
+                      oversized ? h : this->page_size);
+        this->page_list.back().packer.pack(w, h, rect);
+    }
+
+    rect.w = surface->w;
+    rect.h = surface->h;
+    SDL_Surface *page_surface = this->page_list[page].surface.get();
+    this->blit(name, surface, page_surface, rect);
+
+    const auto page_w = static_cast<float>(page_surface->w);
+    const auto page_h = static_cast<float>(page_surface->h);
+    SDL_FRect frect = {static_cast<float>(rect.x), static_cast<float>(rect.y),
+                       static_cast<float>(rect.w), static_cast<float>(rect.h)};
+    AtlasRegion region = {static_cast<int>(page),
+                          frect,
+                          {frect.x / page_w, frect.y / page_h,
+                           frect.w / page_w, frect.h / page_h}};
+
+    return this->regions.insert_or_assign(name, region).first->second;
+}
+
+// Copy the pixels straight in, alpha included, instead of blending them
+// over what is already on the page. Images already in the page format are
+// a plain row copy, anything the blit kernels do not cover goes through
+// SDL.
+void TextureAtlas::blit(const std::string &name, SDL_Surface *surface,
+                        SDL_Surface *page_surface, const SDL_Rect &rect) {
+    if (blitSurface(surface, nullptr, page_surface, &rect, BlitBlend::None)) {
+        return;
+    }
+
+    SDL_BlendMode blend_mode;
+    SDL_GetSurfaceBlendMode(surface, &blend_mode);
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    bool blitted = SDL_BlitSurface(surface, nullptr, page_surface, &rect);
+    SDL_SetSurfaceBlendMode(surface, blend_mode);
+    if (!blitted) {
+        auto error = std::format("Error copying {} into atlas: {}", name,
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+}
+
+void TextureAtlas::build(SDL_Renderer *renderer) {
+    for (Page &page : this->page_list) {
+        page.texture.reset(
+            SDL_CreateTextureFromSurface(renderer, page.surface.get()));
+        if (!page.texture) {
+            auto error = std::format("Error creating atlas Texture: {}",
+                                     SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        SDL_SetTextureBlendMode(page.texture.get(), SDL_BLENDMODE_BLEND);
+    }
+}
+
+// Overwrites a region in place for hot reloading. The page surfaces are kept
+// after build(), so only the changed rect is uploaded to the texture and
+// every region, uv and recorded command stays valid. A new image must have
+// the same size as the one it replaces.
+void TextureAtlas::replace(const std::string &name, SDL_Surface *surface) {
+    const AtlasRegion &found = this->region(name);
+    SDL_Rect rect = {static_cast<int>(found.rect.x),
+                     static_cast<int>(found.rect.y),
+                     static_cast<int>(found.rect.w),
+                     static_cast<int>(found.rect.h)};
+    if (surface->w != rect.w || surface->h != rect.h) {
+        auto error = std::format("Error replacing {}: size changed from {}x{} "
+                                 "to {}x{}",
+                                 name, rect.w, rect.h, surface->w, surface->h);
+        throw std::runtime_error(error);
+    }
+
+    Page &page = this->page_list[static_cast<std::size_t>(found.page)];
+    this->blit(name, surface, page.surface.get(), rect);
+
+    if (page.texture) {
+        const Uint8 *pixels = static_cast<const Uint8 *>(page.surface->pixels);
+        pixels += rect.y * page.surface->pitch + rect.x * 4;
+        if (!SDL_UpdateTexture(page.texture.get(), &rect, pixels,
+                               page.surface->pitch)) {
+            auto error = std::format("Error updating atlas Texture: {}",
+                                     SDL_GetError());
+            throw std::runtime_error(error);
+        }
+    }
+}
+
+void TextureAtlas::clear() {
+    this->regions.clear();
+    this->page_list.clear();
+}
+
+const AtlasRegion &TextureAtlas::region(const std::string &name) const {
+    auto it = this->regions.find(name);
+    if (it == this->regions.end()) {
+        auto error = std::format("Error atlas has no region {}", name);
+        throw std::runtime_error(error);
+    }
+    return it->second;
+}
+
+SDL_Texture *TextureAtlas::texture(int page) const {
+    return this->page_list[static_cast<std::size_t>(page)].texture.get();
+}
+
+SDL_Surface *TextureAtlas::surface(int page) const {
+    return this->page_list[static_cast<std::size_t>(page)].surface.get();
+}
@@ -0,0 +1,78 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "main.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+constexpr int ATLAS_PAGE_SIZE = 1024;
+constexpr int ATLAS_PADDING = 2;
+
+struct AtlasRegion {
+        int page;
+        SDL_FRect rect;
+        SDL_FRect uv;
+};
+
+// Bottom-left skyline rectangle packer. The skyline is the list of top
+// edges of everything packed so far, each new rect sits on the lowest
+// span it fits across.
+class SkylinePacker {
+    public:
+        SkylinePacker(int page_width, int page_height);
+
+        bool pack(int w, int h, SDL_Rect &rect);
+
+    private:
+        struct Node {
+                int x;
+                int y;
+                int w;
+        };
+
+        int fit(std::size_t index, int w, int h) const;
+        void insert(std::size_t index, const SDL_Rect &rect);
+
+        int width;
+        int height;
+        std::vector<Node> skyline;
+};
+
+// Loose images are copied into shared pages so sprites from different files
+// can be drawn from the same texture. The lookup table maps a name to the
+// page and sub-rect it was packed into.
+class TextureAtlas {
+    public:
+        explicit TextureAtlas(int size = ATLAS_PAGE_SIZE);
+
+        const AtlasRegion &add(const std::string &name, SDL_Surface *surface);
+        void build(SDL_Renderer *renderer);
+        void replace(const std::string &name, SDL_Surface *surface);
+        void clear();
+
+        const AtlasRegion &region(const std::string &name) const;
+        SDL_Texture *texture(int page) const;
+        SDL_Surface *surface(int page) const;
+        std::size_t pages() const { return this->page_list.size(); }
+        int pageSize() const { return this->page_size; }
+
+    private:
+        struct Page {
+                SkylinePacker packer;
+                std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>
+                    surface;
+                std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>
+                    texture;
+        };
+
+        void addPage(int width, int height);
+        void blit(const std::string &name, SDL_Surface *surface,
+                  SDL_Surface *page_surface, const SDL_Rect &rect);
+
+        int page_size;
+        std::vector<Page> page_list;
+        std::unordered_map<std::string, AtlasRegion> regions;
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include "blit.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <utility>
+
+constexpr std::array<SDL_PixelFormat, 2> BLIT_FORMATS = {
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888};
+constexpr std::size_t BLIT_BLENDS = 2;
+constexpr std::size_t BLIT_TRANSFORMS = 3;
+constexpr std::size_t BLIT_KERNELS = BLIT_FORMATS.size() *
+                                     BLIT_FORMATS.size() * BLIT_BLENDS *
+                                     BLIT_TRANSFORMS;
+
+// Everything a kernel needs, already clipped. For copies and scales the
+// source origin is the first pixel of the clipped area, rotations keep the
+// whole source and map every destination pixel back into it.
+struct BlitJob {
+        const Uint8 *src;
+        int src_pitch;
+        int src_w;
+        int src_h;
+        Uint8 *dst;
+        int dst_pitch;
+        int dst_w;
+        int dst_h;
+        // Source pixels per destination pixel in 16.16 fixed point, and the
+        // position of the first sample.
+        Uint32 step_x;
+        Uint32 step_y;
+        Uint32 start_x;
+        Uint32 start_y;
+        // Rotations only, destination pixel centres relative to the centre
+        // of the rotated rect and its inverse rotation.
+        float origin_x;
+        float origin_y;
+        float cos;
+        float sin;
+        float scale_x;
+        float scale_y;
+};
+
+using BlitKernel = void (*)(const BlitJob &job);
+
+// Both formats keep alpha in the top byte and differ only in where red and
+// blue go, so converting is a swap of those two bytes.
+template <SDL_PixelFormat Src, SDL_PixelFormat Dst>
+inline Uint32 convertPixel(Uint32 pixel) {
+    if constexpr (Src == Dst) {
+        return pixel;
+    } else {
+        return (pixel & 0xFF00FF00) | (pixel >> 16 & 0xFF) |
+               (pixel & 0xFF) << 16;
+    }
+}
+
+template <SDL_PixelFormat Src, SDL_PixelFormat Dst, BlitBlend Blend,
+          BlitTransform Transform>
+void blitKernel(const BlitJob &job) {
+    auto dstRow = [&job](int y) {
+        return reinterpret_cast<Uint32 *>(job.dst + y * job.dst_pitch);
+    };
+    auto srcRow = [&job](int y) {
+        return reinterpret_cast<const Uint32 *>(job.src + y * job.src_pitch);
+    };
+
+    if constexpr (Transform == BlitTransform::Copy) {
+        // One to one, so the first sample is the clipped offset.
+        int offset_x = static_cast<int>(job.start_x >> 16);
+        int offset_y = static_cast<int>(job.start_y >> 16);
+        for (int y = 0; y < job.dst_h; y++) {
+            Uint32 *dst_row = dstRow(y);
+            const Uint32 *src_row = srcRow(y + offset_y) + offset_x;
+            if constexpr (Src == Dst && Blend == BlitBlend::None) {
+                std::memcpy(dst_row, src_row,
+                            static_cast<std::size_t>(job.dst_w) * 4);
+            } else {
+                for (int x = 0; x < job.dst_w; x++) {
+                    dst_row[x] = blendPixel<Blend>(
+                        convertPixel<Src, Dst>(src_row[x]), dst_row[x]);
+                }
+            }
+        }
+    } else if constexpr (Transform == BlitTransform::Scale) {
+        Uint32 sy = job.start_y;
+        for (int y = 0; y < job.dst_h; y++, sy += job.step_y) {
+            Uint32 *dst_row = dstRow(y);
+            const Uint32 *src_row = srcRow(static_cast<int>(sy >> 16));
+            Uint32 sx = job.start_x;
+            for (int x = 0; x < job.dst_w; x++, sx += job.step_x) {
+                dst_row[x] = blendPixel<Blend>(
+                    convertPixel<Src, Dst>(src_row[sx >> 16]), dst_row[x]);
+            }
+        }
+    } else {
+        const float half_w = static_cast<float>(job.src_w) * 0.5f;
+        const float half_h = static_cast<float>(job.src_h) * 0.5f;
+        for (int y = 0; y < job.dst_h; y++) {
+            Uint32 *dst_row = dstRow(y);
+            float py = job.origin_y + static_cast<float>(y);
+            for (int x = 0; x < job.dst_w; x++) {
+                float px = job.origin_x + static_cast<float>(x);
+                float u = (px * job.cos + py * job.sin) * job.scale_x + half_w;
+                float v = (py * job.cos - px * job.sin) * job.scale_y + half_h;
+                if (u < 0 || v < 0 || u >= static_cast<float>(job.src_w) ||
+                    v >= static_cast<float>(job.src_h)) {
+                    continue;
+                }
+                const Uint32 *src_row = srcRow(static_cast<int>(v));
+                dst_row[x] = blendPixel<Blend>(
+                    convertPixel<Src, Dst>(src_row[static_cast<int>(u)]),
+                    dst_row[x]);
+            }
+        }
+    }
+}
+
+constexpr std::size_t kernelIndex(std::size_t src, std::size_t dst,
+                                  BlitBlend blend, BlitTransform transform) {
+    return ((src * BLIT_FORMATS.size() + dst) * BLIT_BLENDS +
+            static_cast<std::size_t>(blend)) *
+               BLIT_TRANSFORMS +
+           static_cast<std::size_t>(transform);
+}
+
+template <std::size_t Index>
+constexpr BlitKernel makeKernel() {
+    constexpr std::size_t transform = Index % BLIT_TRANSFORMS;
+    constexpr std::size_t blend = Index / BLIT_TRANSFORMS % BLIT_BLENDS;
+    constexpr std::size_t dst =
+        Index / (BLIT_TRANSFORMS * BLIT_BLENDS) % BLIT_FORMATS.size();
+    constexpr std::size_t src =
+        Index / (BLIT_TRANSFORMS * BLIT_BLENDS * BLIT_FORMATS.size());
+    return &blitKernel<BLIT_FORMATS[src], BLIT_FORMATS[dst],
+                       static_cast<BlitBlend>(blend),
+                       static_cast<BlitTransform>(transform)>;
+}
+
+template <std::size_t... Index>
+constexpr std::array<BlitKernel, sizeof...(Index)>
+makeKernels(std::index_sequence<Index...>) {
+    return {makeKernel<Index>()...};
+}
+
+constexpr std::array<BlitKernel, BLIT_KERNELS> BLIT_KERNEL_TABLE =
+    makeKernels(std::make_index_sequence<BLIT_KERNELS>{});
+
+static std::size_t formatIndex(SDL_PixelFormat format) {
+    auto found = std::find(BLIT_FORMATS.begin(), BLIT_FORMATS.end(), format);
+    return static_cast<std::size_t>(found - BLIT_FORMATS.begin());
+}
+
+bool blitSupported(SDL_PixelFormat format) {
+    return formatIndex(format) < BLIT_FORMATS.size();
+}
+
+// Fills in the clipped area for an unrotated blit. Returns false when
+// nothing is left to draw.
+static bool clipJob(BlitJob &job, const SDL_Rect &src, const SDL_Rect &dst,
+                    const SDL_Surface *dst_surface) {
+    job.step_x = static_cast<Uint32>((static_cast<Uint64>(src.w) << 16) /
+                                     static_cast<Uint64>(dst.w));
+    job.step_y = static_cast<Uint32>((static_cast<Uint64>(src.h) << 16) /
+                                     static_cast<Uint64>(dst.h));
+
+    int left = std::max(dst.x, 0);
+    int top = std::max(dst.y, 0);
+    int right = std::min(dst.x + dst.w, dst_surface->w);
+    int bottom = std::min(dst.y + dst.h, dst_surface->h);
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+
+    // Sample at pixel centres, starting from wherever clipping cut in.
+    job.start_x = job.step_x / 2 +
+                  static_cast<Uint32>(left - dst.x) * job.step_x;
+    job.start_y = job.step_y / 2 +
+                  static_cast<Uint32>(top - dst.y) * job.step_y;
+    job.dst += top * job.dst_pitch + left * 4;
+    job.dst_w = right - left;
+    job.dst_h = bottom - top;
+    return true;
+}
+
+bool blitSurface(SDL_Surface *src, const SDL_Rect *src_rect, SDL_Surface *dst,
+                 const SDL_Rect *dst_rect, BlitBlend blend, double angle) {
+    std::size_t src_format = formatIndex(src->format);
+    std::size_t dst_format = formatIndex(dst->format);
+    if (src_format == BLIT_FORMATS.size() ||
+        dst_format == BLIT_FORMATS.size()) {
+        return false;
+    }
+
+    SDL_Rect src_bounds = {0, 0, src->w, src->h};
+    SDL_Rect src_area = src_bounds;
+    if (src_rect && !SDL_GetRectIntersection(src_rect, &src_bounds,
+                                             &src_area)) {
+        return true;
+    }
+    SDL_Rect dst_area = dst_rect ? *dst_rect : SDL_Rect{0, 0, dst->w, dst->h};
+    if (dst_area.w <= 0 || dst_area.h <= 0) {
+        return true;
+    }
+
+    double turns = angle / 360.0;
+    bool rotated = std::abs(turns - std::round(turns)) > 1e-9;
+    BlitTransform transform = BlitTransform::Copy;
+    if (rotated) {
+        transform = BlitTransform::Rotate;
+    } else if (src_area.w != dst_area.w || src_area.h != dst_area.h) {
+        transform = BlitTransform::Scale;
+    }
+
+    if (SDL_MUSTLOCK(src) && !SDL_LockSurface(src)) {
+        return false;
+    }
+    if (SDL_MUSTLOCK(dst) && !SDL_LockSurface(dst)) {
+        if (SDL_MUSTLOCK(src)) {
+            SDL_UnlockSurface(src);
+        }
+        return false;
+    }
+
+    BlitJob job{};
+    job.src = static_cast<const Uint8 *>(src->pixels) +
+              src_area.y * src->pitch + src_area.x * 4;
+    job.src_pitch = src->pitch;
+    job.src_w = src_area.w;
+    job.src_h = src_area.h;
+    job.dst = static_cast<Uint8 *>(dst->pixels);
+    job.dst_pitch = dst->pitch;
+
+    bool visible = true;
+    if (transform != BlitTransform::Rotate) {
+        visible = clipJob(job, src_area, dst_area, dst);
+    } else {
+        // Draw over the bounding box of the rotated rect.
+        double radians = angle * std::numbers::pi / 180.0;
+        float c = static_cast<float>(std::cos(radians));
+        float s = static_cast<float>(std::sin(radians));
+        float half_w = static_cast<float>(dst_area.w) * 0.5f;
+        float half_h = static_cast<float>(dst_area.h) * 0.5f;
+        float extent_x = std::abs(half_w * c) + std::abs(half_h * s);
+        float extent_y = std::abs(half_w * s) + std::abs(half_h * c);
+        float centre_x = static_cast<float>(dst_area.x) + half_w;
+        float centre_y = static_cast<float>(dst_area.y) + half_h;
+
+        int left = std::max(static_cast<int>(std::floor(centre_x - extent_x)),
+                            0);
+        int top = std::max(static_cast<int>(std::floor(centre_y - extent_y)),
+                           0);
+        int right = std::min(static_cast<int>(std::ceil(centre_x + extent_x)),
+                             dst->w);
+        int bottom = std::min(
+            static_cast<int>(std::ceil(centre_y + extent_y)), dst->h);
+        visible = left < right && top < bottom;
+
+        job.dst += top * job.dst_pitch + left * 4;
+        job.dst_w = right - left;
+        job.dst_h = bottom - top;
+        job.origin_x = static_cast<float>(left) + 0.5f - centre_x;
+        job.origin_y = static_cast<float>(top) + 0.5f - centre_y;
+        job.cos = c;
+        job.sin = s;
+        job.scale_x = static_cast<float>(src_area.w) /
+                      static_cast<float>(dst_area.w);
+        job.scale_y = static_cast<float>(src_area.h) /
+                      static_cast<float>(dst_area.h);
+    }
+
+    if (visible) {
+        BLIT_KERNEL_TABLE[kernelIndex(src_format, dst_format, blend,
+                                      transform)](job);
+    }
+
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    if (SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef BLIT_H
+#define BLIT_H
+
+#include "main.h"
+
+enum class BlitBlend : Uint8 { None, Blend };
+enum class BlitTransform : Uint8 { Copy, Scale, Rotate };
+
+// Software blits between 32-bit surfaces without going through SDL's
+// generic blitter. Every combination of source format, destination format,
+// blend mode and transform is its own template instance, picked from a
+// table built at compile time, so the inner loops carry no per pixel
+// branches. An unscaled copy between surfaces of the same format is a
+// memcpy per row.
+//
+// dst_rect is where the unrotated source lands, a null rect means the whole
+// surface. Angles are in degrees clockwise around the centre of dst_rect,
+// as with SDL_RenderTextureRotated. Scaling and rotation sample the nearest
+// pixel. Blend follows SDL_BLENDMODE_BLEND. Returns false without touching
+// anything when a surface has a format with no kernel, the caller then
+// falls back to SDL_BlitSurface.
+bool blitSurface(SDL_Surface *src, const SDL_Rect *src_rect, SDL_Surface *dst,
+                 const SDL_Rect *dst_rect, BlitBlend blend, double angle = 0);
+
+bool blitSupported(SDL_PixelFormat format);
+
+// Red and blue are blended together in the two halves of one word, which
+// works for either byte order because both get the same weight. Each
+// channel is rounded to the nearest of x / 255.
+template <BlitBlend Blend>
+inline Uint32 blendPixel(Uint32 src, Uint32 dst) {
+    if constexpr (Blend == BlitBlend::None) {
+        return src;
+    } else {
+        Uint32 alpha = src >> 24;
+        if (alpha == 0xFF) {
+            return src;
+        }
+        if (alpha == 0) {
+            return dst;
+        }
+        Uint32 inverse = 0xFF - alpha;
+
+        Uint32 rb = (src & 0x00FF00FF) * alpha + (dst & 0x00FF00FF) * inverse +
+                    0x00800080;
+        rb = (rb + (rb >> 8 & 0x00FF00FF)) >> 8 & 0x00FF00FF;
+        Uint32 g = (src >> 8 & 0xFF) * alpha + (dst >> 8 & 0xFF) * inverse +
+                   0x80;
+        g = (g + (g >> 8)) >> 8;
+        Uint32 a = (dst >> 24) * inverse + 0x80;
+        a = alpha + ((a + (a >> 8)) >> 8);
+
+        return a << 24 | g << 8 | rb;
+    }
+}
+
+#endif
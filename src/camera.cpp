@@ -0,0 +1,64 @@
+#include "camera.h"
+#include <algorithm>
+
+Camera::Camera(float width, float height)
+    : screen_w{width},
+      screen_h{height},
+      center_x{width / 2},
+      center_y{height / 2},
+      scale{1},
+      view_rect{} {
+    this->updateView();
+}
+
+void Camera::updateView() {
+    this->view_rect.w = this->screen_w / this->scale;
+    this->view_rect.h = this->screen_h / this->scale;
+    this->view_rect.x = this->center_x - this->view_rect.w / 2;
+    this->view_rect.y = this->center_y - this->view_rect.h / 2;
+}
+
+void Camera::centerOn(float x, float y) {
+    this->center_x = x;
+    this->center_y = y;
+    this->updateView();
+}
+
+void Camera::clampTo(const SDL_FRect &bounds) {
+    float half_w = this->view_rect.w / 2;
+    float half_h = this->view_rect.h / 2;
+
+    // A view larger than the bounds stays centered on them.
+    if (this->view_rect.w >= bounds.w) {
+        this->center_x = bounds.x + bounds.w / 2;
+    } else {
+        this->center_x = std::clamp(this->center_x, bounds.x + half_w,
+                                    bounds.x + bounds.w - half_w);
+    }
+    if (this->view_rect.h >= bounds.h) {
+        this->center_y = bounds.y + bounds.h / 2;
+    } else {
+        this->center_y = std::clamp(this->center_y, bounds.y + half_h,
+                                    bounds.y + bounds.h - half_h);
+    }
+
+    this->updateView();
+}
+
+void Camera::setZoom(float zoom) {
+    this->scale = std::clamp(zoom, CAMERA_ZOOM_MIN, CAMERA_ZOOM_MAX);
+    this->updateView();
+}
+
+bool Camera::visible(const SDL_FRect &rect) const {
+    return rect.x < this->view_rect.x + this->view_rect.w &&
+           rect.x + rect.w > this->view_rect.x &&
+           rect.y < this->view_rect.y + this->view_rect.h &&
+           rect.y + rect.h > this->view_rect.y;
+}
+
+SDL_FRect Camera::toScreen(const SDL_FRect &rect) const {
+    return {(rect.x - this->view_rect.x) * this->scale,
+            (rect.y - this->view_rect.y) * this->scale, rect.w * this->scale,
+            rect.h * this->scale};
+}
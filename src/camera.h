@@ -0,0 +1,37 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "main.h"
+
+constexpr float CAMERA_ZOOM_MIN = 0.25f;
+constexpr float CAMERA_ZOOM_MAX = 4;
+constexpr float CAMERA_ZOOM_STEP = 1.25f;
+
+// A 2D camera looking at a point in the world. The view rect is the part of
+// the world that fills the screen, it shrinks as the zoom grows.
+class Camera {
+    public:
+        Camera(float width = WINDOW_WIDTH, float height = WINDOW_HEIGHT);
+
+        void centerOn(float x, float y);
+        void clampTo(const SDL_FRect &bounds);
+        void setZoom(float zoom);
+
+        float zoom() const { return this->scale; }
+        const SDL_FRect &view() const { return this->view_rect; }
+
+        bool visible(const SDL_FRect &rect) const;
+        SDL_FRect toScreen(const SDL_FRect &rect) const;
+
+    private:
+        void updateView();
+
+        float screen_w;
+        float screen_h;
+        float center_x;
+        float center_y;
+        float scale;
+        SDL_FRect view_rect;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "capture.h"
+#include "trace.h"
+
+FrameCapture::FrameCapture()
+    : directory{},
+      interval{0},
+      frame_count{0},
+      mutex{},
+      ready{},
+      jobs{},
+      captured{0},
+      written{0},
+      dropped{0},
+      failed{0},
+      worker{} {}
+
+// The worker is stopped and joined first, it writes out whatever is still
+// queued before it returns.
+FrameCapture::~FrameCapture() {
+    if (this->worker.joinable()) {
+        this->worker.request_stop();
+        this->worker.join();
+    }
+}
+
+void FrameCapture::start(const char *capture_dir, Uint64 capture_interval) {
+    if (!SDL_CreateDirectory(capture_dir)) {
+        auto error =
+            std::format("Error creating Directory: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->directory = capture_dir;
+    this->interval = capture_interval;
+    this->frame_count = 0;
+    this->worker = std::jthread{
+        [this](std::stop_token stop) { this->encode(stop); }};
+}
+
+// Call after everything is drawn and before SDL_RenderPresent, the back
+// buffer is undefined once it has been presented.
+void FrameCapture::frame(SDL_Renderer *renderer) {
+    if (!this->active()) {
+        return;
+    }
+
+    this->frame_count++;
+    if (this->frame_count % this->interval != 0) {
+        return;
+    }
+
+    std::unique_lock lock{this->mutex};
+    if (this->jobs.size() >= CAPTURE_QUEUE_MAX) {
+        this->dropped++;
+        return;
+    }
+    lock.unlock();
+
+    Job job{{SDL_RenderReadPixels(renderer, nullptr), SDL_DestroySurface},
+            this->frame_count};
+    if (!job.surface) {
+        this->failed++;
+        std::cerr << std::format("Error reading Pixels: {}", SDL_GetError())
+                  << std::endl;
+        return;
+    }
+    this->captured++;
+
+    lock.lock();
+    this->jobs.push_back(std::move(job));
+    lock.unlock();
+    this->ready.notify_one();
+}
+
+void FrameCapture::encode(std::stop_token stop) {
+    traceThreadName("capture");
+    while (true) {
+        std::unique_lock lock{this->mutex};
+        this->ready.wait(lock, stop, [this] { return !this->jobs.empty(); });
+        if (this->jobs.empty()) {
+            return;
+        }
+        Job job = std::move(this->jobs.front());
+        this->jobs.pop_front();
+        lock.unlock();
+
+        TraceScope scope{"savePNG"};
+        std::string path =
+            std::format("{}/frame-{:06}.png", this->directory, job.frame);
+        if (IMG_SavePNG(job.surface.get(), path.c_str())) {
+            this->written++;
+        } else {
+            this->failed++;
+            std::cerr << std::format("Error saving {}: {}", path,
+                                     SDL_GetError())
+                      << std::endl;
+        }
+    }
+}
+
+CaptureStats FrameCapture::stats() const {
+    return {this->captured.load(), this->written.load(), this->dropped.load(),
+            this->failed.load()};
+}
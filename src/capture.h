@@ -0,0 +1,67 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "main.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+constexpr std::size_t CAPTURE_QUEUE_MAX = 8;
+constexpr const char *CAPTURE_DIR = "captures";
+
+struct CaptureStats {
+        Uint64 captured;
+        Uint64 written;
+        Uint64 dropped;
+        Uint64 failed;
+};
+
+// Reads back every interval'th frame with SDL_RenderReadPixels and hands the
+// surface to a worker thread that writes it as a PNG, so encoding never
+// holds up the frame. Only the readback itself runs on the render thread.
+// When the worker falls CAPTURE_QUEUE_MAX frames behind new captures are
+// dropped and counted rather than stalling the game.
+class FrameCapture {
+    public:
+        FrameCapture();
+        ~FrameCapture();
+
+        FrameCapture(const FrameCapture &) = delete;
+        FrameCapture &operator=(const FrameCapture &) = delete;
+
+        void start(const char *directory, Uint64 interval);
+        void frame(SDL_Renderer *renderer);
+
+        bool active() const { return this->interval > 0; }
+        CaptureStats stats() const;
+
+    private:
+        struct Job {
+                std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>
+                    surface;
+                Uint64 frame;
+        };
+
+        void encode(std::stop_token stop);
+
+        std::string directory;
+        Uint64 interval;
+        Uint64 frame_count;
+
+        std::mutex mutex;
+        std::condition_variable_any ready;
+        std::deque<Job> jobs;
+
+        std::atomic<Uint64> captured;
+        std::atomic<Uint64> written;
+        std::atomic<Uint64> dropped;
+        std::atomic<Uint64> failed;
+
+        std::jthread worker;
+};
+
+#endif
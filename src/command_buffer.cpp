@@ -0,0 +1,322 @@
+#include "command_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr int KEY_LAYER_SHIFT = 56;
+constexpr int KEY_TEXTURE_SHIFT = 40;
+constexpr int KEY_BLEND_SHIFT = 32;
+constexpr int RADIX_BITS = 8;
+constexpr std::size_t RADIX_BUCKETS = 1 << RADIX_BITS;
+
+CommandBuffer::CommandBuffer(const TextureAtlas &texture_atlas)
+    : atlas{texture_atlas},
+      culled_count{0} {}
+
+Uint64 CommandBuffer::makeKey(RenderLayer layer, SDL_Texture *texture,
+                              SDL_BlendMode blend) {
+    // Texture ids index this buffer's table plus one, 0 is no texture.
+    Uint64 texture_id = 0;
+    if (texture) {
+        auto it =
+            std::find(this->textures.begin(), this->textures.end(), texture);
+        if (it == this->textures.end()) {
+            this->textures.push_back(texture);
+            it = this->textures.end() - 1;
+        }
+        texture_id = static_cast<Uint64>(it - this->textures.begin()) + 1;
+    }
+
+    // The blend bits only group equal modes, submit() uses the real value.
+    Uint64 blend_id = std::min<Uint64>(blend, 0xFF);
+
+    return static_cast<Uint64>(layer) << KEY_LAYER_SHIFT |
+           (texture_id & 0xFFFF) << KEY_TEXTURE_SHIFT |
+           blend_id << KEY_BLEND_SHIFT;
+}
+
+// Corners go top left, top right, bottom right, bottom left, matching the
+// corners of uv.
+void CommandBuffer::addQuad(RenderLayer layer, SDL_Texture *texture,
+                            const SDL_FRect &uv,
+                            const std::array<float, 4> &xs,
+                            const std::array<float, 4> &ys,
+                            SDL_FColor color) {
+    const float u0 = uv.x;
+    const float v0 = uv.y;
+    const float u1 = uv.x + uv.w;
+    const float v1 = uv.y + uv.h;
+
+    int first = static_cast<int>(this->vertices.size());
+    this->vertices.push_back({{xs[0], ys[0]}, color, {u0, v0}});
+    this->vertices.push_back({{xs[1], ys[1]}, color, {u1, v0}});
+    this->vertices.push_back({{xs[2], ys[2]}, color, {u1, v1}});
+    this->vertices.push_back({{xs[3], ys[3]}, color, {u0, v1}});
+
+    int index = static_cast<int>(this->indices.size());
+    this->indices.insert(this->indices.end(), {first, first + 1, first + 2,
+                                               first + 2, first + 3, first});
+
+    this->commands.push_back(
+        {this->makeKey(layer, texture, SDL_BLENDMODE_BLEND), texture,
+         SDL_BLENDMODE_BLEND, index, 6, -1});
+}
+
+// A textured quad that does not have to come from the atlas, such as a
+// glyph from an SdfFont, tinted by multiplying with color.
+void CommandBuffer::add(RenderLayer layer, SDL_Texture *texture,
+                        const SDL_FRect &uv, const SDL_FRect &dst,
+                        SDL_FColor color) {
+    const float left = dst.x;
+    const float top = dst.y;
+    const float right = dst.x + dst.w;
+    const float bottom = dst.y + dst.h;
+
+    this->addQuad(layer, texture, uv, {left, right, right, left},
+                  {top, top, bottom, bottom}, color);
+}
+
+void CommandBuffer::add(RenderLayer layer, const AtlasRegion &region,
+                        const SDL_FRect &dst) {
+    constexpr SDL_FColor white = {1, 1, 1, 1};
+    this->add(layer, this->atlas.texture(region.page), region.uv, dst, white);
+}
+
+bool CommandBuffer::add(RenderLayer layer, const AtlasRegion &region,
+                        const SDL_FRect &world, const Camera &camera) {
+    if (!camera.visible(world)) {
+        this->culled_count++;
+        return false;
+    }
+
+    this->add(layer, region, camera.toScreen(world));
+    return true;
+}
+
+// The corners are offsets from the center turned and scaled by one 2x2
+// matrix. Every corner is the same expression on a different lane, so the
+// loop compiles to a few vector instructions instead of four rounds of
+// scalar math.
+void CommandBuffer::add(RenderLayer layer, const AtlasRegion &region,
+                        const SDL_FRect &dst,
+                        const SpriteTransform &transform) {
+    constexpr std::array<float, 4> corner_x = {-1, 1, 1, -1};
+    constexpr std::array<float, 4> corner_y = {-1, -1, 1, 1};
+
+    const float radians = transform.angle * (SDL_PI_F / 180);
+    const float cos_scaled = std::cos(radians) * transform.scale;
+    const float sin_scaled = std::sin(radians) * transform.scale;
+    const float half_w = dst.w / 2;
+    const float half_h = dst.h / 2;
+    const float center_x = dst.x + half_w;
+    const float center_y = dst.y + half_h;
+
+    std::array<float, 4> xs;
+    std::array<float, 4> ys;
+    for (std::size_t i = 0; i < xs.size(); i++) {
+        float offset_x = corner_x[i] * half_w;
+        float offset_y = corner_y[i] * half_h;
+        xs[i] = center_x + cos_scaled * offset_x - sin_scaled * offset_y;
+        ys[i] = center_y + sin_scaled * offset_x + cos_scaled * offset_y;
+    }
+
+    this->addQuad(layer, this->atlas.texture(region.page), region.uv, xs, ys,
+                  transform.tint);
+}
+
+// Culls against the circle the sprite sweeps when turning, which avoids a
+// second round of trigonometry for a tighter box. The camera only moves and
+// zooms, so turning about the center works the same on screen.
+bool CommandBuffer::add(RenderLayer layer, const AtlasRegion &region,
+                        const SDL_FRect &world,
+                        const SpriteTransform &transform,
+                        const Camera &camera) {
+    const float radius = transform.scale *
+                         std::sqrt(world.w * world.w + world.h * world.h) / 2;
+    const SDL_FRect bounds{world.x + world.w / 2 - radius,
+                           world.y + world.h / 2 - radius, radius * 2,
+                           radius * 2};
+    if (!camera.visible(bounds)) {
+        this->culled_count++;
+        return false;
+    }
+
+    this->add(layer, region, camera.toScreen(world), transform);
+    return true;
+}
+
+void CommandBuffer::addGeometry(RenderLayer layer, SDL_Texture *texture,
+                                SDL_BlendMode blend, const float *xy,
+                                const SDL_FColor *colors, const float *uv,
+                                int num_vertices, const int *geometry_indices,
+                                int num_indices) {
+    if (num_vertices == 0) {
+        return;
+    }
+
+    // The arrays are referenced, not copied, and must outlive submit().
+    int geometry = static_cast<int>(this->geometries.size());
+    this->geometries.push_back(
+        {xy, colors, uv, num_vertices, geometry_indices, num_indices});
+    this->commands.push_back({this->makeKey(layer, texture, blend), texture,
+                              blend, 0, 0, geometry});
+}
+
+void CommandBuffer::append(const CommandBuffer &other) {
+    int vertex_offset = static_cast<int>(this->vertices.size());
+    int index_offset = static_cast<int>(this->indices.size());
+    int geometry_offset = static_cast<int>(this->geometries.size());
+
+    this->vertices.insert(this->vertices.end(), other.vertices.begin(),
+                          other.vertices.end());
+    for (int index : other.indices) {
+        this->indices.push_back(index + vertex_offset);
+    }
+    this->geometries.insert(this->geometries.end(), other.geometries.begin(),
+                            other.geometries.end());
+
+    for (Command command : other.commands) {
+        // Texture ids are local to each buffer, so keys are rebuilt here.
+        auto layer =
+            static_cast<RenderLayer>(command.key >> KEY_LAYER_SHIFT);
+        command.key = this->makeKey(layer, command.texture, command.blend);
+        if (command.geometry < 0) {
+            command.first += index_offset;
+        } else {
+            command.geometry += geometry_offset;
+        }
+        this->commands.push_back(command);
+    }
+
+    this->culled_count += other.culled_count;
+}
+
+void CommandBuffer::radixSort() {
+    const std::size_t count = this->commands.size();
+    this->order.resize(count);
+    this->order_tmp.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        this->order[i] = static_cast<Uint32>(i);
+    }
+
+    // Least significant digit first. Each pass is stable, and passes where
+    // every key has the same digit are skipped, so the unused low bits of
+    // the key cost nothing.
+    for (int shift = 0; shift < 64; shift += RADIX_BITS) {
+        std::array<std::size_t, RADIX_BUCKETS> histogram{};
+        for (const Command &command : this->commands) {
+            histogram[(command.key >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        if (std::find(histogram.begin(), histogram.end(), count) !=
+            histogram.end()) {
+            continue;
+        }
+
+        std::size_t total = 0;
+        for (std::size_t &bucket : histogram) {
+            std::size_t size = bucket;
+            bucket = total;
+            total += size;
+        }
+
+        for (Uint32 index : this->order) {
+            Uint64 key = this->commands[index].key;
+            this->order_tmp[histogram[(key >> shift) & (RADIX_BUCKETS - 1)]++] =
+                index;
+        }
+        this->order.swap(this->order_tmp);
+    }
+}
+
+void CommandBuffer::sort() {
+    this->radixSort();
+
+    this->merged_indices.clear();
+    this->batch_list.clear();
+
+    for (Uint32 index : this->order) {
+        const Command &command = this->commands[index];
+
+        if (command.geometry >= 0) {
+            this->batch_list.push_back(
+                {command.texture, command.blend, 0, 0, command.geometry});
+            continue;
+        }
+
+        if (this->batch_list.empty() ||
+            this->batch_list.back().geometry >= 0 ||
+            this->batch_list.back().texture != command.texture ||
+            this->batch_list.back().blend != command.blend) {
+            this->batch_list.push_back(
+                {command.texture, command.blend,
+                 static_cast<int>(this->merged_indices.size()), 0, -1});
+        }
+
+        auto first = this->indices.begin() + command.first;
+        this->merged_indices.insert(this->merged_indices.end(), first,
+                                    first + command.count);
+        this->batch_list.back().count += command.count;
+    }
+}
+
+CommandBatch CommandBuffer::batch(std::size_t index) const {
+    const Batch &batch = this->batch_list[index];
+
+    if (batch.geometry >= 0) {
+        const Geometry &geometry =
+            this->geometries[static_cast<std::size_t>(batch.geometry)];
+        return {batch.texture,
+                batch.blend,
+                geometry.xy,
+                2 * sizeof(float),
+                geometry.colors,
+                sizeof(SDL_FColor),
+                geometry.uv,
+                2 * sizeof(float),
+                geometry.num_vertices,
+                geometry.indices,
+                geometry.num_indices};
+    }
+
+    const SDL_Vertex *vertex = this->vertices.data();
+    return {batch.texture,
+            batch.blend,
+            vertex ? &vertex->position.x : nullptr,
+            sizeof(SDL_Vertex),
+            vertex ? &vertex->color : nullptr,
+            sizeof(SDL_Vertex),
+            vertex ? &vertex->tex_coord.x : nullptr,
+            sizeof(SDL_Vertex),
+            static_cast<int>(this->vertices.size()),
+            this->merged_indices.data() + batch.first,
+            batch.count};
+}
+
+void CommandBuffer::submit(SDL_Renderer *renderer) const {
+    for (std::size_t i = 0; i < this->batch_list.size(); i++) {
+        CommandBatch batch = this->batch(i);
+        if (batch.texture) {
+            SDL_SetTextureBlendMode(batch.texture, batch.blend);
+        } else {
+            SDL_SetRenderDrawBlendMode(renderer, batch.blend);
+        }
+
+        SDL_RenderGeometryRaw(renderer, batch.texture, batch.xy,
+                              batch.xy_stride, batch.colors,
+                              batch.color_stride, batch.uv, batch.uv_stride,
+                              batch.num_vertices, batch.indices,
+                              batch.num_indices, sizeof(int));
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+void CommandBuffer::clear() {
+    this->vertices.clear();
+    this->indices.clear();
+    this->commands.clear();
+    this->geometries.clear();
+    this->textures.clear();
+    this->merged_indices.clear();
+    this->batch_list.clear();
+    this->culled_count = 0;
+}
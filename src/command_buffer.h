@@ -0,0 +1,133 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include "atlas.h"
+#include "camera.h"
+#include <array>
+
+enum class RenderLayer : Uint8 {
+    Background,
+    World,
+    Sprites,
+    Particles,
+    Overlay,
+};
+
+// How a sprite is drawn about the center of its rectangle: turned by angle
+// degrees clockwise as with SDL_RenderTextureRotated, scaled, and multiplied
+// by tint as with SDL_SetTextureColorMod. All of it ends up in the vertices,
+// so transformed sprites merge into the same batches as plain ones.
+struct SpriteTransform {
+        float angle;
+        float scale;
+        SDL_FColor tint;
+};
+
+// One draw call of a sorted buffer, laid out like the arguments of
+// SDL_RenderGeometryRaw. uv is null for untextured geometry.
+struct CommandBatch {
+        SDL_Texture *texture;
+        SDL_BlendMode blend;
+        const float *xy;
+        int xy_stride;
+        const SDL_FColor *colors;
+        int color_stride;
+        const float *uv;
+        int uv_stride;
+        int num_vertices;
+        const int *indices;
+        int num_indices;
+};
+
+// Draw commands are recorded with a 64-bit sort key instead of being sent to
+// the renderer straight away. The key packs layer, texture and blend mode
+// from the most significant bits down:
+//
+//   63..56 layer   55..40 texture   39..32 blend   31..0 unused
+//
+// sort() radix sorts the keys and merges neighbouring sprite commands that
+// share a texture and blend mode into one SDL_RenderGeometry call. Only
+// submit() touches the SDL_Renderer, so worker threads can record into their
+// own buffers which are then append()ed on the render thread.
+class CommandBuffer {
+    public:
+        explicit CommandBuffer(const TextureAtlas &texture_atlas);
+
+        void add(RenderLayer layer, SDL_Texture *texture, const SDL_FRect &uv,
+                 const SDL_FRect &dst, SDL_FColor color);
+        void add(RenderLayer layer, const AtlasRegion &region,
+                 const SDL_FRect &dst);
+        bool add(RenderLayer layer, const AtlasRegion &region,
+                 const SDL_FRect &world, const Camera &camera);
+        void add(RenderLayer layer, const AtlasRegion &region,
+                 const SDL_FRect &dst, const SpriteTransform &transform);
+        bool add(RenderLayer layer, const AtlasRegion &region,
+                 const SDL_FRect &world, const SpriteTransform &transform,
+                 const Camera &camera);
+        void addGeometry(RenderLayer layer, SDL_Texture *texture,
+                         SDL_BlendMode blend, const float *xy,
+                         const SDL_FColor *colors, const float *uv,
+                         int num_vertices, const int *indices,
+                         int num_indices);
+        void append(const CommandBuffer &other);
+
+        void sort();
+        void submit(SDL_Renderer *renderer) const;
+        void clear();
+
+        // Valid after sort() until the next clear(), in submit order.
+        CommandBatch batch(std::size_t index) const;
+
+        std::size_t size() const { return this->commands.size(); }
+        std::size_t batches() const { return this->batch_list.size(); }
+        std::size_t culled() const { return this->culled_count; }
+
+    private:
+        struct Command {
+                Uint64 key;
+                SDL_Texture *texture;
+                SDL_BlendMode blend;
+                int first;
+                int count;
+                int geometry;
+        };
+
+        struct Geometry {
+                const float *xy;
+                const SDL_FColor *colors;
+                const float *uv;
+                int num_vertices;
+                const int *indices;
+                int num_indices;
+        };
+
+        struct Batch {
+                SDL_Texture *texture;
+                SDL_BlendMode blend;
+                int first;
+                int count;
+                int geometry;
+        };
+
+        Uint64 makeKey(RenderLayer layer, SDL_Texture *texture,
+                       SDL_BlendMode blend);
+        void addQuad(RenderLayer layer, SDL_Texture *texture,
+                     const SDL_FRect &uv, const std::array<float, 4> &xs,
+                     const std::array<float, 4> &ys, SDL_FColor color);
+        void radixSort();
+
+        const TextureAtlas &atlas;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+        std::vector<Command> commands;
+        std::vector<Geometry> geometries;
+        std::vector<SDL_Texture *> textures;
+
+        std::vector<Uint32> order;
+        std::vector<Uint32> order_tmp;
+        std::vector<int> merged_indices;
+        std::vector<Batch> batch_list;
+        std::size_t culled_count;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "context.h"
+
+SdlContext::SdlContext(bool headless) : is_headless{headless} {
+    if (!SDL_Init(headless ? 0 : SDL_FLAGS)) {
+        auto error = std::format("Error initialize SDL3: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    if (!TTF_Init()) {
+        auto error =
+            std::format("Error initialize SDL_ttf: {}", SDL_GetError());
+        SDL_Quit();
+        throw std::runtime_error(error);
+    }
+
+    if (headless) {
+        return;
+    }
+
+    if ((Mix_Init(MIX_FLAGS) & MIX_FLAGS) != MIX_FLAGS) {
+        auto error =
+            std::format("Error initialize SDL_mixer: {}", SDL_GetError());
+        TTF_Quit();
+        SDL_Quit();
+        throw std::runtime_error(error);
+    }
+
+    SDL_AudioSpec audiospec;
+    audiospec.freq = MIX_DEFAULT_FREQUENCY;
+    audiospec.format = MIX_DEFAULT_FORMAT;
+    audiospec.channels = MIX_DEFAULT_CHANNELS;
+
+    if (!Mix_OpenAudio(0, &audiospec)) {
+        auto error = std::format("Error Opening Audio: {}", SDL_GetError());
+        Mix_Quit();
+        TTF_Quit();
+        SDL_Quit();
+        throw std::runtime_error(error);
+    }
+}
+
+SdlContext::~SdlContext() {
+    if (!this->is_headless) {
+        Mix_CloseAudio();
+        Mix_Quit();
+    }
+    TTF_Quit();
+    SDL_Quit();
+}
@@ -0,0 +1,23 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "main.h"
+
+// Owns the process wide SDL, SDL_ttf and SDL_mixer lifetimes. Create one in
+// main() and any number of Game or World instances can share it. A headless
+// context skips video and audio entirely.
+class SdlContext {
+    public:
+        explicit SdlContext(bool headless = false);
+        ~SdlContext();
+
+        SdlContext(const SdlContext &) = delete;
+        SdlContext &operator=(const SdlContext &) = delete;
+
+        bool headless() const { return this->is_headless; }
+
+    private:
+        bool is_headless;
+};
+
+#endif
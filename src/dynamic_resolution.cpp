@@ -0,0 +1,131 @@
+#include "dynamic_resolution.h"
+#include <algorithm>
+
+DynamicResolution::DynamicResolution()
+    : target{nullptr, SDL_DestroyTexture},
+      width{0},
+      height{0},
+      target_width{0},
+      target_height{0},
+      budget{0},
+      level{0},
+      render_scale{1},
+      smoothed_ms{0},
+      settle{0},
+      start{0} {}
+
+// width and height are the logical size the scene is drawn at.
+void DynamicResolution::setup(SDL_Renderer *renderer, int logical_width,
+                              int logical_height, double budget_ms) {
+    this->width = logical_width;
+    this->height = logical_height;
+    this->createTarget(renderer);
+
+    this->budget = budget_ms;
+    this->level = 0;
+    this->render_scale = 1;
+    this->smoothed_ms = 0;
+    this->settle = DYNAMIC_RESOLUTION_SETTLE_FRAMES;
+}
+
+// The controller keeps its scale, only the cost of a frame at that scale
+// changes and has to show up in the smoothed time again.
+void DynamicResolution::resize(SDL_Renderer *renderer) {
+    if (!this->active()) {
+        return;
+    }
+    this->createTarget(renderer);
+    this->settle = DYNAMIC_RESOLUTION_SETTLE_FRAMES;
+}
+
+void DynamicResolution::reset() { this->target.reset(); }
+
+// The target matches the letterboxed area the logical size fills in the
+// output. It is allocated at full size, lower scales only use its top left
+// corner, so changing the scale never reallocates.
+void DynamicResolution::createTarget(SDL_Renderer *renderer) {
+    int output_w = 0;
+    int output_h = 0;
+    if (!SDL_GetCurrentRenderOutputSize(renderer, &output_w, &output_h)) {
+        auto error =
+            std::format("Error getting output size: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    float fit = std::min(static_cast<float>(output_w) /
+                             static_cast<float>(this->width),
+                         static_cast<float>(output_h) /
+                             static_cast<float>(this->height));
+    int new_width = std::max(1, static_cast<int>(
+                                    static_cast<float>(this->width) * fit));
+    int new_height = std::max(1, static_cast<int>(
+                                     static_cast<float>(this->height) * fit));
+
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                          SDL_TEXTUREACCESS_TARGET, new_width, new_height),
+        SDL_DestroyTexture};
+    if (!texture) {
+        auto error =
+            std::format("Error creating target Texture: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(texture.get(), SDL_SCALEMODE_LINEAR);
+
+    this->target = std::move(texture);
+    this->target_width = new_width;
+    this->target_height = new_height;
+}
+
+void DynamicResolution::begin(SDL_Renderer *renderer) {
+    this->start = SDL_GetTicksNS();
+    SDL_SetRenderTarget(renderer, this->target.get());
+    float scale_x = this->render_scale *
+                    static_cast<float>(this->target_width) /
+                    static_cast<float>(this->width);
+    float scale_y = this->render_scale *
+                    static_cast<float>(this->target_height) /
+                    static_cast<float>(this->height);
+    SDL_SetRenderScale(renderer, scale_x, scale_y);
+}
+
+// Renderers batch their commands, the flush makes the drawing happen now
+// rather than inside the present.
+void DynamicResolution::end(SDL_Renderer *renderer) {
+    SDL_SetRenderScale(renderer, 1, 1);
+    SDL_SetRenderTarget(renderer, nullptr);
+
+    SDL_FRect used{
+        0, 0, static_cast<float>(this->target_width) * this->render_scale,
+        static_cast<float>(this->target_height) * this->render_scale};
+    SDL_RenderTexture(renderer, this->target.get(), &used, nullptr);
+    SDL_FlushRenderer(renderer);
+
+    this->update(static_cast<double>(SDL_GetTicksNS() - this->start) /
+                 SDL_NS_PER_MS);
+}
+
+void DynamicResolution::update(double render_ms) {
+    this->smoothed_ms = this->smoothed_ms > 0
+                            ? this->smoothed_ms +
+                                  (render_ms - this->smoothed_ms) *
+                                      DYNAMIC_RESOLUTION_SMOOTHING
+                            : render_ms;
+    if (this->settle > 0) {
+        this->settle--;
+        return;
+    }
+
+    int next = this->level;
+    if (this->smoothed_ms > this->budget * DYNAMIC_RESOLUTION_DOWN_AT) {
+        next = std::min(next + 1, DYNAMIC_RESOLUTION_LEVELS);
+    } else if (this->smoothed_ms < this->budget * DYNAMIC_RESOLUTION_UP_AT) {
+        next = std::max(next - 1, 0);
+    }
+    if (next != this->level) {
+        this->level = next;
+        this->render_scale =
+            1.0f - static_cast<float>(next) * DYNAMIC_RESOLUTION_STEP;
+        this->settle = DYNAMIC_RESOLUTION_SETTLE_FRAMES;
+    }
+}
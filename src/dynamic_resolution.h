@@ -0,0 +1,62 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include "main.h"
+
+constexpr float DYNAMIC_RESOLUTION_STEP = 0.125f;
+// Steps below full size, the lowest scale is 1 - 4 * 0.125 = 0.5.
+constexpr int DYNAMIC_RESOLUTION_LEVELS = 4;
+// Fractions of the frame budget the smoothed render time has to cross
+// before the scale moves down or up.
+constexpr double DYNAMIC_RESOLUTION_DOWN_AT = 0.9;
+constexpr double DYNAMIC_RESOLUTION_UP_AT = 0.6;
+constexpr double DYNAMIC_RESOLUTION_SMOOTHING = 0.1;
+constexpr int DYNAMIC_RESOLUTION_SETTLE_FRAMES = 30;
+
+// Renders the scene into an offscreen target at a fraction of the size it
+// takes up in the window and stretches it over the window, lowering the
+// fraction while rendering takes longer than the frame budget and raising
+// it again when there is room. Full size is the output in pixels, so a
+// resized or high-DPI window reaches native resolution. Drawing between
+// begin() and end() uses logical coordinates as usual, a render scale maps
+// them into the used corner of the target.
+//
+// The time measured is from begin() to the end of a renderer flush in
+// end(), so it is the drawing work and not the wait for vsync. After every
+// change the scale holds for a while, the new cost first has to show up in
+// the smoothed time before it can be judged.
+class DynamicResolution {
+    public:
+        DynamicResolution();
+
+        void setup(SDL_Renderer *renderer, int width, int height,
+                   double budget_ms);
+        // Call when the window's size in pixels changes.
+        void resize(SDL_Renderer *renderer);
+        void reset();
+
+        void begin(SDL_Renderer *renderer);
+        void end(SDL_Renderer *renderer);
+        void update(double render_ms);
+
+        bool active() const { return static_cast<bool>(this->target); }
+        float scale() const { return this->render_scale; }
+        double renderMs() const { return this->smoothed_ms; }
+
+    private:
+        void createTarget(SDL_Renderer *renderer);
+
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> target;
+        int width;
+        int height;
+        int target_width;
+        int target_height;
+        double budget;
+        int level;
+        float render_scale;
+        double smoothed_ms;
+        int settle;
+        Uint64 start;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+
+FramePacer::FramePacer()
+    : frequency{SDL_GetPerformanceFrequency()},
+      period{0},
+      deadline{0},
+      last_frame{0},
+      refresh_rate{0},
+      vsync_enabled{false},
+      probe_frames{0},
+      probe_short{0},
+      history{},
+      history_count{0},
+      history_next{0} {
+    this->setRate(FRAME_PACER_DEFAULT_RATE);
+}
+
+void FramePacer::setup(SDL_Window *window, SDL_Renderer *renderer) {
+    float hz = FRAME_PACER_DEFAULT_RATE;
+    const SDL_DisplayMode *mode =
+        SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+    if (mode && mode->refresh_rate > 0) {
+        hz = mode->refresh_rate;
+    }
+    this->setRate(hz);
+
+    // Not every renderer can sync to the display, the software renderer on
+    // a dummy or offscreen target for one. Those fall back to the timer, so
+    // do renderers that report vsync off after it was set.
+    int vsync = 0;
+    this->vsync_enabled = SDL_SetRenderVSync(renderer, 1) &&
+                          SDL_GetRenderVSync(renderer, &vsync) && vsync != 0;
+    this->probe_frames = 0;
+    this->probe_short = 0;
+}
+
+void FramePacer::setRate(float hz) {
+    this->refresh_rate = hz;
+    this->period = static_cast<Uint64>(static_cast<double>(this->frequency) /
+                                       static_cast<double>(hz));
+    this->deadline = SDL_GetPerformanceCounter() + this->period;
+}
+
+void FramePacer::wait() {
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (!this->vsync_enabled) {
+        if (now < this->deadline) {
+            Uint64 remaining_ns =
+                (this->deadline - now) * SDL_NS_PER_SECOND / this->frequency;
+            if (remaining_ns > FRAME_PACER_SPIN_NS) {
+                SDL_DelayNS(remaining_ns - FRAME_PACER_SPIN_NS);
+            }
+            while (SDL_GetPerformanceCounter() < this->deadline) {
+            }
+            now = SDL_GetPerformanceCounter();
+        }
+
+        // A frame that ran long starts a new schedule instead of being
+        // followed by a burst of short frames catching up.
+        this->deadline += this->period;
+        if (this->deadline < now) {
+            this->deadline = now + this->period;
+        }
+    }
+
+    if (this->last_frame != 0 && this->vsync_enabled &&
+        this->probe_frames < FRAME_PACER_PROBE_FRAMES) {
+        if (now - this->last_frame < this->period * 3 / 4) {
+            this->probe_short++;
+        }
+        this->probe_frames++;
+        if (this->probe_frames == FRAME_PACER_PROBE_FRAMES &&
+            this->probe_short > FRAME_PACER_PROBE_FRAMES / 2) {
+            this->vsync_enabled = false;
+            this->deadline = now + this->period;
+        }
+    }
+
+    if (this->last_frame != 0) {
+        this->history[this->history_next] = now - this->last_frame;
+        this->history_next = (this->history_next + 1) % FRAME_PACER_HISTORY;
+        this->history_count =
+            std::min(this->history_count + 1, FRAME_PACER_HISTORY);
+    }
+    this->last_frame = now;
+}
+
+FrameStats FramePacer::stats() const {
+    FrameStats stats{this->history_count, 0, 0, 0, 0};
+    if (this->history_count == 0) {
+        return stats;
+    }
+
+    const double to_ms = 1000.0 / static_cast<double>(this->frequency);
+    double sum = 0;
+    double sum_sq = 0;
+    stats.min_ms = static_cast<double>(this->history[0]) * to_ms;
+    for (std::size_t i = 0; i < this->history_count; i++) {
+        double ms = static_cast<double>(this->history[i]) * to_ms;
+        sum += ms;
+        sum_sq += ms * ms;
+        stats.min_ms = std::min(stats.min_ms, ms);
+        stats.max_ms = std::max(stats.max_ms, ms);
+    }
+
+    double count = static_cast<double>(this->history_count);
+    stats.mean_ms = sum / count;
+    double variance = sum_sq / count - stats.mean_ms * stats.mean_ms;
+    stats.jitter_ms = std::sqrt(std::max(0.0, variance));
+    return stats;
+}
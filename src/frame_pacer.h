@@ -0,0 +1,56 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "main.h"
+#include <array>
+
+constexpr float FRAME_PACER_DEFAULT_RATE = 60;
+constexpr Uint64 FRAME_PACER_SPIN_NS = 2 * SDL_NS_PER_MS;
+constexpr std::size_t FRAME_PACER_HISTORY = 240;
+constexpr std::size_t FRAME_PACER_PROBE_FRAMES = 30;
+
+struct FrameStats {
+        std::size_t frames;
+        double mean_ms;
+        double jitter_ms;
+        double min_ms;
+        double max_ms;
+};
+
+// Paces the render loop to the display refresh rate. With vsync the present
+// itself blocks and wait() only measures. Without it wait() sleeps for most
+// of the remaining frame and spins on the performance counter for the last
+// couple of milliseconds, since a sleep alone can overshoot by a whole
+// scheduler tick.
+//
+// A renderer can accept vsync and still return from present straight away,
+// so the first FRAME_PACER_PROBE_FRAMES frames are timed as well. When most
+// of them are clearly shorter than a refresh, wait() takes over the pacing.
+class FramePacer {
+    public:
+        FramePacer();
+
+        void setup(SDL_Window *window, SDL_Renderer *renderer);
+        void setRate(float hz);
+        void wait();
+
+        bool vsync() const { return this->vsync_enabled; }
+        float rate() const { return this->refresh_rate; }
+        FrameStats stats() const;
+
+    private:
+        Uint64 frequency;
+        Uint64 period;
+        Uint64 deadline;
+        Uint64 last_frame;
+        float refresh_rate;
+        bool vsync_enabled;
+        std::size_t probe_frames;
+        std::size_t probe_short;
+
+        std::array<Uint64, FRAME_PACER_HISTORY> history;
+        std::size_t history_count;
+        std::size_t history_next;
+};
+
+#endif
@@ -0,0 +1,794 @@
+#include "game.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+Game::~Game() {
+    Mix_HaltChannel(-1);
+    Mix_HaltMusic();
+
+    this->rasterizer.reset();
+    this->resolution.reset();
+    this->hud_text.reset();
+    this->hud_font.reset();
+    this->music.reset();
+    this->bounce_sound.reset();
+    this->color_sound.reset();
+    this->fonts.clear();
+    this->atlas.clear();
+    this->icon_surf.reset();
+    this->renderer.reset();
+    this->window.reset();
+}
+
+static std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>
+loadSurface(const SceneAsset &asset) {
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surf{
+        IMG_Load(asset.path.c_str()), SDL_DestroySurface};
+    if (!surf) {
+        auto error = std::format("Error loading Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return surf;
+}
+
+static std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)>
+loadChunk(const SceneAsset &asset) {
+    std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)> chunk{
+        Mix_LoadWAV(asset.path.c_str()), Mix_FreeChunk};
+    if (!chunk) {
+        auto error = std::format("Error loading Chunk: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return chunk;
+}
+
+static std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)>
+loadMusic(const SceneAsset &asset) {
+    std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)> music{
+        Mix_LoadMUS(asset.path.c_str()), Mix_FreeMusic};
+    if (!music) {
+        auto error = std::format("Error loading Music: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return music;
+}
+
+void Game::initSdl() {
+    TraceScope scope{"initSdl"};
+    this->window.reset(SDL_CreateWindow(
+        this->scene.title.c_str(), this->scene.window_w, this->scene.window_h,
+        SDL_WINDOW_RESIZABLE));
+    if (!this->window) {
+        auto error = std::format("Error creating Window: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->renderer.reset(SDL_CreateRenderer(this->window.get(), nullptr));
+    if (!this->renderer) {
+        auto error = std::format("Error creating Renderer: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    // Everything is drawn in scene coordinates, SDL scales that to whatever
+    // size the window is resized to and letterboxes the rest.
+    if (!SDL_SetRenderLogicalPresentation(
+            this->renderer.get(), this->scene.window_w, this->scene.window_h,
+            SDL_LOGICAL_PRESENTATION_LETTERBOX)) {
+        auto error = std::format("Error setting logical presentation: {}",
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->pacer.setup(this->window.get(), this->renderer.get());
+
+    // The software rasterizer draws at a fixed size of its own.
+    if (this->options.dynamic_resolution &&
+        this->options.raster_threads == 0) {
+        this->resolution.setup(this->renderer.get(), this->scene.window_w,
+                               this->scene.window_h,
+                               1000.0 / this->pacer.rate());
+    }
+
+    if (this->scene.icon != SCENE_NONE) {
+        this->icon_surf = loadSurface(this->scene.assets[this->scene.icon]);
+        SDL_SetWindowIcon(this->window.get(), this->icon_surf.get());
+    }
+}
+
+// Every image in the scene goes into the atlas under its asset name, texts
+// are drawn from the distance field of their font at whatever size they end
+// up on screen. Animation frames are cut from their sheet in the atlas once
+// here. Sounds named color and bounce are played for those world events and
+// the first music asset loops in the background.
+void Game::loadMedia() {
+    TraceScope scope{"loadMedia"};
+    WorldSetup setup{this->scene,
+                     std::vector<SDL_FPoint>(this->scene.assets.size()),
+                     PARTICLE_CAPACITY};
+    bool music_found = false;
+    this->fonts.resize(this->scene.assets.size());
+
+    for (std::size_t i = 0; i < this->scene.assets.size(); i++) {
+        const SceneAsset &asset = this->scene.assets[i];
+        switch (asset.kind) {
+        case AssetKind::Image:
+            this->atlas.add(asset.name, loadSurface(asset).get());
+            break;
+        case AssetKind::Font:
+            this->fonts[i].load(asset.path);
+            this->fonts[i].build(this->renderer.get(),
+                                 this->options.raster_threads > 0);
+            break;
+        case AssetKind::Sound:
+            if (asset.name == "color") {
+                this->color_sound = loadChunk(asset);
+            } else if (asset.name == "bounce") {
+                this->bounce_sound = loadChunk(asset);
+            }
+            break;
+        case AssetKind::Music:
+            if (!music_found) {
+                this->music = loadMusic(asset);
+                music_found = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    this->atlas.build(this->renderer.get());
+
+    if (this->options.raster_threads > 0) {
+        this->rasterizer.setup(this->scene.window_w, this->scene.window_h,
+                               this->options.raster_threads);
+        this->addRasterTextures();
+    }
+
+    // The HUD uses the first font in the scene, a scene without fonts has
+    // no HUD.
+    auto font_asset = std::find_if(
+        this->scene.assets.begin(), this->scene.assets.end(),
+        [](const SceneAsset &asset) { return asset.kind == AssetKind::Font; });
+    if (font_asset != this->scene.assets.end()) {
+        this->hud_font.reset(
+            TTF_OpenFont(font_asset->path.c_str(), HUD_TEXT_SIZE));
+        if (!this->hud_font) {
+            auto error = std::format("Error creating Font: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        this->hud_text.setup(this->renderer.get(), this->hud_font.get());
+    }
+
+    this->animation_frames = bakeAnimationFrames(this->scene, this->atlas);
+    const SceneTilemap &scene_tilemap = this->scene.tilemap;
+    if (scene_tilemap.image != SCENE_NONE) {
+        const SceneAsset &tileset = this->scene.assets[scene_tilemap.image];
+        const AtlasRegion &tileset_region = this->atlas.region(tileset.name);
+        // A tile past the last cell would sample whatever image sits next
+        // to the tileset on its atlas page.
+        int cells = (static_cast<int>(tileset_region.rect.w) / TILE_SIZE) *
+                    (static_cast<int>(tileset_region.rect.h) / TILE_SIZE);
+        Uint16 last_tile = *std::max_element(scene_tilemap.tiles.begin(),
+                                             scene_tilemap.tiles.end());
+        if (last_tile > cells) {
+            auto error =
+                std::format("Error tilemap uses tile {}, image {} holds {}",
+                            last_tile, tileset.name, cells);
+            throw std::runtime_error(error);
+        }
+        this->tilemap.emplace(this->atlas, tileset_region,
+                              scene_tilemap.columns, scene_tilemap.rows);
+        for (int y = 0; y < scene_tilemap.rows; y++) {
+            for (int x = 0; x < scene_tilemap.columns; x++) {
+                this->tilemap->setTile(
+                    x, y,
+                    scene_tilemap.tiles[static_cast<std::size_t>(
+                        y * scene_tilemap.columns + x)]);
+            }
+        }
+    }
+    this->sprite_regions.assign(this->scene.assets.size(), AtlasRegion{});
+    for (std::size_t i = 0; i < this->scene.assets.size(); i++) {
+        const SceneAsset &asset = this->scene.assets[i];
+        if (asset.kind == AssetKind::Image) {
+            this->sprite_regions[i] = this->atlas.region(asset.name);
+            setup.sprite_sizes[i] = {this->sprite_regions[i].rect.w,
+                                     this->sprite_regions[i].rect.h};
+        } else if (asset.kind == AssetKind::Text) {
+            setup.sprite_sizes[i] =
+                this->fonts[asset.font].measure(asset.path, asset.size);
+        }
+    }
+
+    this->world = World{setup};
+    this->countMemory();
+    this->countAudio();
+}
+
+void Game::init() {
+    this->initSdl();
+
+    this->loadMedia();
+
+    this->world.seed(this->options.seed.value_or(std::random_device()()));
+
+    if (this->options.capture_interval > 0) {
+        this->capture.start(CAPTURE_DIR, this->options.capture_interval);
+    }
+    if (this->options.hot_reload) {
+        std::vector<std::string> directories;
+        for (const SceneAsset &asset : this->scene.assets) {
+            std::size_t slash = asset.path.rfind('/');
+            if (asset.kind == AssetKind::Text ||
+                slash == std::string::npos) {
+                continue;
+            }
+            std::string directory = asset.path.substr(0, slash);
+            if (std::find(directories.begin(), directories.end(),
+                          directory) == directories.end()) {
+                directories.push_back(std::move(directory));
+            }
+        }
+        this->watcher.start(directories);
+    }
+    if (this->options.record_path) {
+        this->recorder.start(this->renderer.get(), this->options.record_path,
+                             RECORD_FPS);
+    }
+}
+
+void Game::events() {
+    TraceScope scope{"events"};
+    while (SDL_PollEvent(&this->event)) {
+        switch (event.type) {
+        case SDL_EVENT_QUIT:
+            this->is_running = false;
+            break;
+        case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+            this->resolution.resize(this->renderer.get());
+            break;
+        case SDL_EVENT_KEY_DOWN:
+            switch (event.key.scancode) {
+            case SDL_SCANCODE_ESCAPE:
+                this->is_running = false;
+                break;
+            case SDL_SCANCODE_SPACE:
+                this->color_requests++;
+                break;
+            case SDL_SCANCODE_EQUALS:
+                this->zoom_steps++;
+                break;
+            case SDL_SCANCODE_MINUS:
+                this->zoom_steps--;
+                break;
+            case SDL_SCANCODE_F3:
+                this->show_hud = !this->show_hud && this->hud_font;
+                break;
+            case SDL_SCANCODE_F5:
+                this->save_request = true;
+                break;
+            case SDL_SCANCODE_F9:
+                this->load_request = true;
+                break;
+            case SDL_SCANCODE_F10:
+                this->writeTrace();
+                break;
+            default:
+                break;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    this->pollInput();
+}
+
+// Events and keyboard state belong to the main thread, the simulation only
+// sees these request counters and input bits.
+void Game::pollInput() {
+    Uint8 keys = 0;
+    if (this->keystate[SDL_SCANCODE_LEFT] || this->keystate[SDL_SCANCODE_A]) {
+        keys |= INPUT_LEFT;
+    }
+    if (this->keystate[SDL_SCANCODE_RIGHT] || this->keystate[SDL_SCANCODE_D]) {
+        keys |= INPUT_RIGHT;
+    }
+    if (this->keystate[SDL_SCANCODE_UP] || this->keystate[SDL_SCANCODE_W]) {
+        keys |= INPUT_UP;
+    }
+    if (this->keystate[SDL_SCANCODE_DOWN] || this->keystate[SDL_SCANCODE_S]) {
+        keys |= INPUT_DOWN;
+    }
+    this->input.store(keys, std::memory_order_relaxed);
+}
+
+void Game::update() {
+    TraceScope scope{"update"};
+    this->reloadSounds();
+
+    if (this->load_request.exchange(false)) {
+        this->quickload();
+    }
+
+    WorldInput world_input{this->input.load(std::memory_order_relaxed),
+                           this->color_requests.exchange(0),
+                           this->zoom_steps.exchange(0)};
+
+    WorldEvents world_events = this->world.update(world_input);
+    this->ticks++;
+
+    if (this->color_sound) {
+        for (int i = 0; i < world_events.color_changes; i++) {
+            Mix_PlayChannel(-1, this->color_sound.get(), 0);
+        }
+    }
+    if (this->bounce_sound) {
+        for (int i = 0; i < world_events.bounces; i++) {
+            Mix_PlayChannel(-1, this->bounce_sound.get(), 0);
+        }
+    }
+
+    if (this->save_request.exchange(false)) {
+        this->quicksave();
+    }
+}
+
+// Quicksaves run inside update() so they happen between ticks on whichever
+// thread owns the world. A missing or damaged file is reported and the game
+// carries on.
+void Game::quicksave() {
+    try {
+        Uint64 hash = this->world.save(this->snapshot);
+        saveSnapshotFile(SNAPSHOT_PATH, this->snapshot);
+        std::cout << std::format("Saved {} ({} bytes, hash {:016x})\n",
+                                 SNAPSHOT_PATH, this->snapshot.size(), hash);
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void Game::quickload() {
+    try {
+        loadSnapshotFile(SNAPSHOT_PATH, this->snapshot);
+        this->world.load(this->snapshot);
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+// Textures and music belong to the render thread, so their reloads run there
+// between frames. Sound chunks are played from update(), which may be on the
+// simulation thread, so they are swapped at the start of a tick instead.
+void Game::reloadAssets() {
+    if (!this->options.hot_reload) {
+        return;
+    }
+    auto not_sound = [this](const std::string &path) {
+        std::size_t asset = this->scene.findPath(path);
+        return asset != SCENE_NONE &&
+               this->scene.assets[asset].kind != AssetKind::Sound;
+    };
+    for (const std::string &path : this->watcher.takeChanged(not_sound)) {
+        this->reload(path);
+    }
+}
+
+void Game::reloadSounds() {
+    if (!this->options.hot_reload) {
+        return;
+    }
+    auto sound = [this](const std::string &path) {
+        std::size_t asset = this->scene.findPath(path);
+        return asset != SCENE_NONE &&
+               this->scene.assets[asset].kind == AssetKind::Sound;
+    };
+    for (const std::string &path : this->watcher.takeChanged(sound)) {
+        this->reload(path);
+    }
+}
+
+// The new asset is fully loaded before the old one is released, so a file
+// that fails to load leaves the running game untouched. Paths that are in
+// the watched folders but not in the scene are dropped by the filters above.
+void Game::reload(const std::string &path) {
+    TraceScope scope{"reload"};
+    Uint64 start = SDL_GetTicksNS();
+    std::size_t index = this->scene.findPath(path);
+    const SceneAsset &asset = this->scene.assets[index];
+
+    try {
+        switch (asset.kind) {
+        case AssetKind::Image: {
+            auto surf = loadSurface(asset);
+            this->atlas.replace(asset.name, surf.get());
+            if (index == this->scene.icon) {
+                SDL_SetWindowIcon(this->window.get(), surf.get());
+                this->icon_surf = std::move(surf);
+            }
+            break;
+        }
+        case AssetKind::Font: {
+            // The simulation thread reads glyphs while recording, so the
+            // font can only be swapped when recording happens here.
+            if (this->options.pipelined) {
+                throw std::runtime_error("fonts are not reloaded while "
+                                         "pipelined");
+            }
+            SdfFont font;
+            font.load(asset.path);
+            font.build(this->renderer.get(), this->rasterizer.active());
+            this->fonts[index] = std::move(font);
+            if (this->rasterizer.active()) {
+                this->addRasterTextures();
+            }
+
+            // The current frame still points at the old glyph textures.
+            this->record(this->frames.back());
+            this->frames.publish();
+            this->frames.acquire();
+            break;
+        }
+        case AssetKind::Sound:
+            if (asset.name == "color") {
+                this->color_sound = loadChunk(asset);
+            } else if (asset.name == "bounce") {
+                this->bounce_sound = loadChunk(asset);
+            }
+            break;
+        case AssetKind::Music: {
+            auto first = std::find_if(
+                this->scene.assets.begin(), this->scene.assets.end(),
+                [](const SceneAsset &music_asset) {
+                    return music_asset.kind == AssetKind::Music;
+                });
+            if (&*first != &asset) {
+                return;
+            }
+            auto new_music = loadMusic(asset);
+            if (!Mix_PlayMusic(new_music.get(), -1)) {
+                auto error =
+                    std::format("Error playing Music: {}", SDL_GetError());
+                throw std::runtime_error(error);
+            }
+            this->music = std::move(new_music);
+            break;
+        }
+        default:
+            return;
+        }
+    } catch (const std::runtime_error &e) {
+        std::cerr << std::format("Error reloading {}: {}", path, e.what())
+                  << std::endl;
+        return;
+    }
+
+    // Sounds are swapped by the thread that runs update(), the rest on the
+    // render thread, and each only counts what it owns.
+    if (asset.kind == AssetKind::Sound) {
+        this->countAudio();
+    } else {
+        this->countMemory();
+    }
+    double ms = static_cast<double>(SDL_GetTicksNS() - start) / 1e6;
+    std::cout << std::format("Reloaded {} in {:.2f} ms\n", path, ms);
+}
+
+// Recounted from what is loaded rather than tracked per allocation, a reload
+// that replaces an asset simply changes the next count. Music streams from
+// its file and the HUD font rasterizes through FreeType on demand, so neither
+// holds much beyond what is counted here.
+void Game::countMemory() const {
+    Uint64 textures = 0;
+    Uint64 surfaces = memorySurfaceBytes(this->icon_surf.get());
+    for (std::size_t page = 0; page < this->atlas.pages(); page++) {
+        textures +=
+            memoryTextureBytes(this->atlas.texture(static_cast<int>(page)));
+        surfaces +=
+            memorySurfaceBytes(this->atlas.surface(static_cast<int>(page)));
+    }
+
+    Uint64 font_bytes = 0;
+    for (const SdfFont &font : this->fonts) {
+        font_bytes += font.atlasBytes();
+        for (std::size_t bucket = 0; bucket < font.buckets(); bucket++) {
+            textures += memoryTextureBytes(font.texture(bucket));
+            surfaces += memorySurfaceBytes(font.surface(bucket));
+        }
+    }
+
+    memorySetCategory(MemoryCategory::Textures, textures);
+    memorySetCategory(MemoryCategory::Surfaces, surfaces);
+    memorySetCategory(MemoryCategory::Fonts, font_bytes);
+}
+
+// Reads the sound chunks, so only call it from the thread that plays and
+// reloads them.
+void Game::countAudio() const {
+    Uint64 audio = 0;
+    for (const Mix_Chunk *chunk :
+         {this->color_sound.get(), this->bounce_sound.get()}) {
+        audio += chunk ? chunk->alen : 0;
+    }
+    memorySetCategory(MemoryCategory::Audio, audio);
+}
+
+// The atlas pages are updated in place on reload, only rebuilt fonts bring
+// new textures. Entries for released textures are never looked up again.
+void Game::addRasterTextures() {
+    for (std::size_t page = 0; page < this->atlas.pages(); page++) {
+        this->rasterizer.addTexture(
+            this->atlas.texture(static_cast<int>(page)),
+            this->atlas.surface(static_cast<int>(page)));
+    }
+    for (const SdfFont &font : this->fonts) {
+        for (std::size_t bucket = 0; bucket < font.buckets(); bucket++) {
+            this->rasterizer.addTexture(font.texture(bucket),
+                                        font.surface(bucket));
+        }
+    }
+}
+
+void Game::record(Frame &frame) const {
+    TraceScope scope{"record"};
+    const Camera &camera = this->world.camera();
+
+    frame.clear_color = this->world.drawColor();
+    frame.tick = this->ticks;
+
+    frame.commands.clear();
+    // Recorded first, so the tileset gets the lowest texture id and the map
+    // sorts below the static entities that share the background layer.
+    if (this->tilemap) {
+        this->tilemap->batch(camera, frame.tiles);
+        this->tilemap->record(frame.commands, frame.tiles);
+    }
+    for (std::size_t i = 0; i < this->world.entities(); i++) {
+        RenderLayer layer = this->world.entityBehavior(i) == Behavior::Static
+                                ? RenderLayer::Background
+                                : RenderLayer::Sprites;
+        Uint32 sprite = this->world.entitySprite(i);
+        const SceneAsset &asset = this->scene.assets[sprite];
+        SDL_FRect rect = this->world.entityRect(i);
+
+        if (asset.kind == AssetKind::Animation) {
+            frame.commands.add(
+                layer, this->animation_frames[this->world.entityFrame(i)],
+                rect, this->world.entityTransform(i), camera);
+        } else if (asset.kind != AssetKind::Text) {
+            frame.commands.add(layer, this->sprite_regions[sprite], rect,
+                               this->world.entityTransform(i), camera);
+        } else if (camera.visible(rect)) {
+            // Text is laid out at its on screen size, so zooming in keeps
+            // the edges sharp instead of stretching the scene size.
+            SDL_FRect screen = camera.toScreen(rect);
+            this->fonts[asset.font].record(frame.commands, layer, asset.path,
+                                           screen.x, screen.y,
+                                           asset.size * screen.h / rect.h,
+                                           asset.color);
+        }
+    }
+
+    this->world.particles().batch(camera, frame.particles);
+    this->world.particles().record(frame.commands, frame.particles);
+
+    frame.commands.sort();
+}
+
+void Game::draw(const Frame &frame) {
+    TraceScope scope{"draw"};
+    if (this->rasterizer.active()) {
+        this->rasterizer.draw(frame.commands, frame.clear_color);
+        this->rasterizer.present(this->renderer.get());
+    } else {
+        if (this->resolution.active()) {
+            this->resolution.begin(this->renderer.get());
+        }
+        SDL_SetRenderDrawColor(this->renderer.get(), frame.clear_color.r,
+                               frame.clear_color.g, frame.clear_color.b,
+                               frame.clear_color.a);
+        SDL_RenderClear(this->renderer.get());
+
+        frame.commands.submit(this->renderer.get());
+        if (this->resolution.active()) {
+            this->resolution.end(this->renderer.get());
+        }
+    }
+
+    if (this->show_hud) {
+        this->drawHud(frame);
+    }
+
+    this->capture.frame(this->renderer.get());
+    this->recorder.frame(this->renderer.get());
+
+    {
+        TraceScope present{"present"};
+        SDL_RenderPresent(this->renderer.get());
+    }
+    memoryFrame();
+}
+
+// Every line changes most frames, but the values repeat, so most strings
+// are still in the text cache from an earlier frame. Lines are formatted
+// into a stack buffer so a cache hit allocates nothing.
+void Game::drawHud(const Frame &frame) {
+    TraceScope scope{"drawHud"};
+    FrameStats frame_stats = this->pacer.stats();
+    TextCacheStats text_stats = this->hud_text.stats();
+    double fps = frame_stats.mean_ms > 0 ? 1000.0 / frame_stats.mean_ms : 0;
+
+    std::array<char, 96> line;
+    float y = HUD_MARGIN;
+    auto print = [this, &line, &y](auto result) {
+        std::size_t length =
+            std::min(static_cast<std::size_t>(result.size), line.size());
+        this->hud_text.draw({line.data(), length}, HUD_MARGIN, y, HUD_COLOR);
+        y += HUD_TEXT_SIZE * 1.25f;
+    };
+
+    print(std::format_to_n(line.data(), line.size(), "{:.0f} fps {:.2f} ms",
+                           fps, frame_stats.mean_ms));
+    print(std::format_to_n(line.data(), line.size(), "tick {}", frame.tick));
+    print(std::format_to_n(line.data(), line.size(),
+                           "{} commands in {} batches", frame.commands.size(),
+                           frame.commands.batches()));
+    print(std::format_to_n(line.data(), line.size(),
+                           "{} particles drawn, {} culled",
+                           frame.particles.quads, frame.particles.culled));
+    if (this->tilemap) {
+        print(std::format_to_n(line.data(), line.size(),
+                               "{} tiles in {} chunks, {} culled",
+                               frame.tiles.stats.tiles_drawn,
+                               frame.tiles.stats.chunks_drawn,
+                               frame.tiles.stats.chunks_culled));
+    }
+    print(std::format_to_n(line.data(), line.size(),
+                           "text cache {} hits, {} misses",
+                           text_stats.hits, text_stats.misses));
+    MemoryStats memory = memoryStats();
+    Uint64 asset_bytes = 0;
+    for (Uint64 bytes : memory.category_bytes) {
+        asset_bytes += bytes;
+    }
+    print(std::format_to_n(line.data(), line.size(), "assets {:.1f} MB",
+                           static_cast<double>(asset_bytes) / MEMORY_MB));
+    if (MEMORY_HEAP_TRACKED) {
+        print(std::format_to_n(line.data(), line.size(),
+                               "heap {:.1f} MB, {} allocations per frame",
+                               static_cast<double>(memory.heap_bytes) /
+                                   MEMORY_MB,
+                               memory.frame_allocations));
+    }
+    if (this->resolution.active()) {
+        print(std::format_to_n(line.data(), line.size(),
+                               "render scale {:.0f}% {:.2f} ms",
+                               this->resolution.scale() * 100,
+                               this->resolution.renderMs()));
+    }
+}
+
+// The simulation steps at a fixed rate on its own thread and publishes
+// every frame it records, the render thread draws whichever frame is newest.
+void Game::simulate(std::stop_token stop) {
+    traceThreadName("simulation");
+    const std::chrono::nanoseconds tick{UPDATE_NS};
+    auto next = std::chrono::steady_clock::now();
+
+    while (this->is_running && !stop.stop_requested()) {
+        this->update();
+        this->record(this->frames.back());
+        this->frames.publish();
+
+        next += tick;
+        TraceScope wait{"wait"};
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Game::runPipelined() {
+    std::jthread simulation{
+        [this](std::stop_token stop) { this->simulate(stop); }};
+
+    while (this->is_running) {
+        TraceScope frame{"frame"};
+        this->reloadAssets();
+        this->events();
+
+        this->frames.acquire();
+        this->draw(this->frames.front());
+
+        TraceScope wait{"wait"};
+        this->pacer.wait();
+    }
+}
+
+void Game::run() {
+    if (this->music && !Mix_PlayMusic(this->music.get(), -1)) {
+        auto error = std::format("Error playing Music: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    if (this->options.pipelined) {
+        this->runPipelined();
+    } else {
+        this->runFixed();
+    }
+
+    if (this->capture.active()) {
+        CaptureStats stats = this->capture.stats();
+        std::cout << std::format("Captured {} frames to {}/, {} dropped, {} "
+                                 "failed\n",
+                                 stats.captured, CAPTURE_DIR, stats.dropped,
+                                 stats.failed);
+    }
+    if (this->recorder.active()) {
+        RecordStats stats = this->recorder.stats();
+        std::cout << std::format("Recorded {} frames to {}, {} dropped, {} "
+                                 "failed\n",
+                                 stats.recorded, this->options.record_path,
+                                 stats.dropped, stats.failed);
+    }
+    if (MEMORY_HEAP_TRACKED) {
+        std::cout << "Memory\n" << memoryReport();
+    }
+}
+
+// Everything recorded up to now, the markers keep recording afterwards and
+// a later write contains these events again.
+void Game::writeTrace() const {
+    if (!this->options.trace_path) {
+        return;
+    }
+    try {
+        std::size_t events = traceWrite(this->options.trace_path);
+        std::cout << std::format("Wrote {} trace events to {}\n", events,
+                                 this->options.trace_path);
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void Game::runFixed() {
+    // The display may refresh faster or slower than the simulation, so
+    // update() runs in fixed steps for the time that passed and the newest
+    // result is drawn once per display frame. While capturing or recording
+    // every frame is exactly one step, so captured frame N always shows tick
+    // N and runs with the same seed can be compared against golden images.
+    const bool lockstep = this->capture.active() || this->recorder.active();
+    Uint64 previous = SDL_GetTicksNS();
+    Uint64 lag = UPDATE_NS;
+
+    while (this->is_running) {
+        TraceScope frame{"frame"};
+        this->reloadAssets();
+        this->events();
+
+        Uint64 now = SDL_GetTicksNS();
+        lag += now - previous;
+        previous = now;
+        if (lockstep) {
+            lag = UPDATE_NS;
+        }
+
+        if (lag >= UPDATE_NS) {
+            for (int steps = 0; lag >= UPDATE_NS && steps < MAX_UPDATE_STEPS;
+                 steps++) {
+                this->update();
+                lag -= UPDATE_NS;
+            }
+            lag = std::min(lag, UPDATE_NS);
+
+            this->record(this->frames.back());
+            this->frames.publish();
+            this->frames.acquire();
+        }
+
+        this->draw(this->frames.front());
+
+        TraceScope wait{"wait"};
+        this->pacer.wait();
+    }
+}
@@ -0,0 +1,172 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "main.h"
+#include "asset_watcher.h"
+#include "capture.h"
+#include "command_buffer.h"
+#include "dynamic_resolution.h"
+#include "frame_pacer.h"
+#include "headless.h"
+#include "image_compare.h"
+#include "memory.h"
+#include "recorder.h"
+#include "sdf_font.h"
+#include "soft_raster.h"
+#include "text_cache.h"
+#include "tilemap.h"
+#include "trace.h"
+#include "triple_buffer.h"
+#include "world.h"
+#include <atomic>
+#include <optional>
+#include <stop_token>
+
+constexpr float HUD_TEXT_SIZE = 18;
+constexpr float HUD_MARGIN = 8;
+constexpr SDL_Color HUD_COLOR = {255, 255, 255, 255};
+
+// Every field defaults to what the game does without that command line
+// option, so callers only name what they change.
+struct GameOptions {
+        bool pipelined = false;
+        bool hot_reload = false;
+        const char *scene_path = SCENE_PATH;
+        std::size_t headless_worlds = 0;
+        std::size_t headless_threads = 0;
+        Uint64 headless_ticks = HEADLESS_TICKS;
+        std::optional<Uint64> seed;
+        Uint64 capture_interval = 0;
+        const char *record_path = nullptr;
+        const char *compare_golden = nullptr;
+        const char *compare_actual = nullptr;
+        int compare_tolerance = COMPARE_TOLERANCE;
+        std::size_t raster_threads = 0;
+        bool dynamic_resolution = false;
+        const char *trace_path = nullptr;
+};
+
+// Everything the renderer needs to draw one simulated frame.
+struct Frame {
+        explicit Frame(const TextureAtlas &atlas)
+            : commands{atlas},
+              particles{},
+              tiles{},
+              clear_color{0, 0, 0, 255},
+              tick{0} {}
+
+        CommandBuffer commands;
+        ParticleVertices particles;
+        TilemapVertices tiles;
+        SDL_Color clear_color;
+        Uint64 tick;
+};
+
+class Game {
+    public:
+        explicit Game(const GameOptions &game_options = {})
+            : options{game_options},
+              is_running{true},
+              color_requests{0},
+              zoom_steps{0},
+              save_request{false},
+              load_request{false},
+              input{0},
+              event{},
+              keystate{SDL_GetKeyboardState(nullptr)},
+              window{nullptr, SDL_DestroyWindow},
+              renderer{nullptr, SDL_DestroyRenderer},
+              icon_surf{nullptr, SDL_DestroySurface},
+              color_sound{nullptr, Mix_FreeChunk},
+              bounce_sound{nullptr, Mix_FreeChunk},
+              music{nullptr, Mix_FreeMusic},
+              scene{loadScene(game_options.scene_path)},
+              atlas{},
+              sprite_regions{},
+              animation_frames{},
+              tilemap{},
+              fonts{},
+              world{{{WINDOW_WIDTH, WINDOW_HEIGHT, {}, SCENE_NONE, {}, {},
+                      {}, {SCENE_NONE, 0, 0, {}}},
+                     {},
+                     PARTICLE_CAPACITY}},
+              snapshot{},
+              frames{atlas},
+              pacer{},
+              resolution{},
+              capture{},
+              recorder{},
+              watcher{},
+              rasterizer{},
+              hud_font{nullptr, TTF_CloseFont},
+              hud_text{},
+              show_hud{false},
+              ticks{0} {}
+
+        ~Game();
+
+        void init();
+        void run();
+
+    private:
+        void initSdl();
+        void loadMedia();
+        void events();
+        void pollInput();
+        void update();
+        void quicksave();
+        void quickload();
+        void reloadAssets();
+        void reloadSounds();
+        void reload(const std::string &path);
+        void addRasterTextures();
+        void countMemory() const;
+        void countAudio() const;
+        void writeTrace() const;
+        void record(Frame &frame) const;
+        void draw(const Frame &frame);
+        void drawHud(const Frame &frame);
+        void runPipelined();
+        void runFixed();
+        void simulate(std::stop_token stop);
+
+        GameOptions options;
+        std::atomic<bool> is_running;
+        std::atomic<int> color_requests;
+        std::atomic<int> zoom_steps;
+        std::atomic<bool> save_request;
+        std::atomic<bool> load_request;
+        std::atomic<Uint8> input;
+        SDL_Event event;
+
+        const bool *keystate;
+
+        std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> window;
+        std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer;
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> icon_surf;
+        std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)> color_sound;
+        std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)> bounce_sound;
+        std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)> music;
+
+        Scene scene;
+        TextureAtlas atlas;
+        std::vector<AtlasRegion> sprite_regions;
+        std::vector<AtlasRegion> animation_frames;
+        std::optional<Tilemap> tilemap;
+        std::vector<SdfFont> fonts;
+        World world;
+        std::vector<std::byte> snapshot;
+        TripleBuffer<Frame> frames;
+        FramePacer pacer;
+        DynamicResolution resolution;
+        FrameCapture capture;
+        VideoRecorder recorder;
+        AssetWatcher watcher;
+        SoftRasterizer rasterizer;
+        std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> hud_font;
+        TextCache hud_text;
+        bool show_hud;
+        Uint64 ticks;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "headless.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+HeadlessResult runHeadless(const WorldSetup &setup, std::size_t worlds,
+                           std::size_t threads, Uint64 ticks) {
+    threads = std::clamp<std::size_t>(threads, 1,
+                                      std::max<std::size_t>(1, worlds));
+
+    std::vector<World> instances;
+    instances.reserve(worlds);
+    for (std::size_t i = 0; i < worlds; i++) {
+        instances.emplace_back(setup);
+        instances.back().seed(HEADLESS_SEED, i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&instances, t, threads, ticks] {
+                traceThreadName(std::format("headless {}", t));
+                for (Uint64 tick = 0; tick < ticks; tick++) {
+                    TraceScope scope{"tick"};
+                    WorldInput input{0, 0, 0};
+                    if (tick % HEADLESS_COLOR_INTERVAL == 0) {
+                        input.color_requests = 1;
+                    }
+                    for (std::size_t i = t; i < instances.size();
+                         i += threads) {
+                        instances[i].update(input);
+                    }
+                }
+            });
+        }
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    Uint64 total = ticks * worlds;
+    return {worlds, threads, total, seconds,
+            static_cast<double>(total) / seconds};
+}
@@ -0,0 +1,24 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "world.h"
+
+constexpr Uint64 HEADLESS_TICKS = 6000;
+constexpr int HEADLESS_COLOR_INTERVAL = 60;
+constexpr Uint64 HEADLESS_SEED = 1;
+
+struct HeadlessResult {
+        std::size_t worlds;
+        std::size_t threads;
+        Uint64 ticks;
+        double seconds;
+        double ticks_per_second;
+};
+
+// Steps many independent worlds as fast as possible, split evenly across
+// worker threads. Every world changes color at a fixed interval so the
+// particle system stays busy.
+HeadlessResult runHeadless(const WorldSetup &setup, std::size_t worlds,
+                           std::size_t threads, Uint64 ticks);
+
+#endif
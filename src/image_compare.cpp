@@ -0,0 +1,128 @@
+#include "image_compare.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+using SurfacePtr = std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>;
+
+// Returns the surface itself when it is already RGBA32, otherwise keeps a
+// converted copy alive in converted and returns that.
+static SDL_Surface *rgba(SDL_Surface *surface, SurfacePtr &converted) {
+    if (surface->format == SDL_PIXELFORMAT_RGBA32) {
+        return surface;
+    }
+
+    converted.reset(SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32));
+    if (!converted) {
+        auto error =
+            std::format("Error converting Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return converted.get();
+}
+
+ImageDiff compareImages(SDL_Surface *golden, SDL_Surface *actual,
+                        int tolerance, SDL_Surface *diff) {
+    if (golden->w != actual->w || golden->h != actual->h) {
+        auto error = std::format("Image sizes differ: {}x{} and {}x{}",
+                                 golden->w, golden->h, actual->w, actual->h);
+        throw std::runtime_error(error);
+    }
+
+    if (diff && diff->format != SDL_PIXELFORMAT_RGBA32) {
+        throw std::runtime_error("Error diff Surface must be RGBA32");
+    }
+
+    // Both sides are converted to RGBA32 so a golden PNG without alpha still
+    // compares equal to a frame read back from the renderer, and the loop
+    // below can assume four bytes per pixel.
+    SurfacePtr golden_rgba{nullptr, SDL_DestroySurface};
+    SurfacePtr actual_rgba{nullptr, SDL_DestroySurface};
+    golden = rgba(golden, golden_rgba);
+    actual = rgba(actual, actual_rgba);
+
+    ImageDiff result{golden->w, golden->h, 0, 0, 0};
+    Uint64 total_delta = 0;
+
+    for (int y = 0; y < golden->h; y++) {
+        const Uint8 *g_row =
+            static_cast<const Uint8 *>(golden->pixels) + y * golden->pitch;
+        const Uint8 *a_row =
+            static_cast<const Uint8 *>(actual->pixels) + y * actual->pitch;
+        Uint8 *d_row = diff ? static_cast<Uint8 *>(diff->pixels) +
+                                  y * diff->pitch
+                            : nullptr;
+
+        for (int x = 0; x < golden->w; x++) {
+            int delta = 0;
+            for (int c = 0; c < 4; c++) {
+                delta = std::max(delta, std::abs(g_row[x * 4 + c] -
+                                                 a_row[x * 4 + c]));
+            }
+            total_delta += static_cast<Uint64>(delta);
+            result.max_delta = std::max(result.max_delta, delta);
+
+            bool differs = delta > tolerance;
+            if (differs) {
+                result.differing++;
+            }
+
+            if (d_row) {
+                Uint8 gray = static_cast<Uint8>(
+                    (g_row[x * 4] + g_row[x * 4 + 1] + g_row[x * 4 + 2]) / 6);
+                d_row[x * 4] = differs ? 255 : gray;
+                d_row[x * 4 + 1] = differs ? 0 : gray;
+                d_row[x * 4 + 2] = differs ? 0 : gray;
+                d_row[x * 4 + 3] = 255;
+            }
+        }
+    }
+
+    Uint64 pixels = static_cast<Uint64>(golden->w) *
+                    static_cast<Uint64>(golden->h);
+    if (pixels > 0) {
+        result.mean_delta =
+            static_cast<double>(total_delta) / static_cast<double>(pixels);
+    }
+
+    return result;
+}
+
+bool compareImageFiles(const char *golden_path, const char *actual_path,
+                       int tolerance) {
+    SurfacePtr golden{IMG_Load(golden_path), SDL_DestroySurface};
+    SurfacePtr actual{IMG_Load(actual_path), SDL_DestroySurface};
+    if (!golden || !actual) {
+        auto error = std::format("Error loading Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    SurfacePtr diff{
+        SDL_CreateSurface(golden->w, golden->h, SDL_PIXELFORMAT_RGBA32),
+        SDL_DestroySurface};
+    if (!diff) {
+        auto error = std::format("Error creating Surface: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    ImageDiff result =
+        compareImages(golden.get(), actual.get(), tolerance, diff.get());
+
+    std::cout << std::format("{}x{}: {} pixels differ, max delta {}, mean "
+                             "delta {:.4f}\n",
+                             result.width, result.height, result.differing,
+                             result.max_delta, result.mean_delta);
+
+    if (result.differing == 0) {
+        return true;
+    }
+
+    std::string diff_path = std::string{actual_path} + ".diff.png";
+    if (!IMG_SavePNG(diff.get(), diff_path.c_str())) {
+        auto error = std::format("Error saving {}: {}", diff_path,
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    std::cout << std::format("Wrote {}\n", diff_path);
+
+    return false;
+}
@@ -0,0 +1,28 @@
+#ifndef IMAGE_COMPARE_H
+#define IMAGE_COMPARE_H
+
+#include "main.h"
+
+constexpr int COMPARE_TOLERANCE = 0;
+
+struct ImageDiff {
+        int width;
+        int height;
+        Uint64 differing;
+        int max_delta;
+        double mean_delta;
+};
+
+// Compares two images channel by channel. A pixel differs when any channel
+// is more than tolerance apart. Both images may be in any format. When diff
+// is given it must be RGBA32 and is filled with the golden image dimmed to
+// gray and every differing pixel in red.
+ImageDiff compareImages(SDL_Surface *golden, SDL_Surface *actual,
+                        int tolerance, SDL_Surface *diff = nullptr);
+
+// Loads both files, compares them and writes <actual>.diff.png when they
+// differ. Returns true when the images match within tolerance.
+bool compareImageFiles(const char *golden_path, const char *actual_path,
+                       int tolerance);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MAIN_H
+#define MAIN_H
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <SDL3_mixer/SDL_mixer.h>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+
+constexpr SDL_InitFlags SDL_FLAGS = SDL_INIT_VIDEO;
+constexpr MIX_InitFlags MIX_FLAGS = MIX_INIT_OGG;
+
+constexpr int WINDOW_WIDTH = 800;
+constexpr int WINDOW_HEIGHT = 600;
+
+constexpr Uint64 UPDATE_NS = SDL_NS_PER_SECOND / 60;
+constexpr float UPDATE_DT = 1.0f / 60.0f;
+constexpr int MAX_UPDATE_STEPS = 5;
+
+#endif
@@ -0,0 +1,165 @@
+#include "memory.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::array<std::atomic<Uint64>, MEMORY_CATEGORIES> category_bytes{};
+static std::atomic<Uint64> heap_bytes{0};
+static std::atomic<Uint64> heap_peak{0};
+static std::atomic<Uint64> allocations{0};
+static std::atomic<Uint64> frame_start{0};
+static std::atomic<Uint64> frame_allocations{0};
+
+void memorySetCategory(MemoryCategory category, Uint64 bytes) {
+    category_bytes[static_cast<std::size_t>(category)].store(
+        bytes, std::memory_order_relaxed);
+}
+
+void memoryFrame() {
+    Uint64 total = allocations.load(std::memory_order_relaxed);
+    Uint64 start = frame_start.exchange(total, std::memory_order_relaxed);
+    frame_allocations.store(total - start, std::memory_order_relaxed);
+}
+
+MemoryStats memoryStats() {
+    MemoryStats stats{};
+    for (std::size_t i = 0; i < MEMORY_CATEGORIES; i++) {
+        stats.category_bytes[i] =
+            category_bytes[i].load(std::memory_order_relaxed);
+    }
+    stats.heap_bytes = heap_bytes.load(std::memory_order_relaxed);
+    stats.heap_peak = heap_peak.load(std::memory_order_relaxed);
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.frame_allocations =
+        frame_allocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// What the texture takes up on the GPU before any padding the driver adds.
+Uint64 memoryTextureBytes(const SDL_Texture *texture) {
+    if (!texture) {
+        return 0;
+    }
+    return static_cast<Uint64>(texture->w) *
+           static_cast<Uint64>(texture->h) *
+           static_cast<Uint64>(SDL_BYTESPERPIXEL(texture->format));
+}
+
+Uint64 memorySurfaceBytes(const SDL_Surface *surface) {
+    if (!surface) {
+        return 0;
+    }
+    return static_cast<Uint64>(surface->pitch) *
+           static_cast<Uint64>(surface->h);
+}
+
+const char *memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::Textures:
+        return "textures";
+    case MemoryCategory::Surfaces:
+        return "surfaces";
+    case MemoryCategory::Audio:
+        return "audio";
+    case MemoryCategory::Fonts:
+        return "fonts";
+    default:
+        return "unknown";
+    }
+}
+
+std::string memoryReport() {
+    MemoryStats stats = memoryStats();
+
+    std::string report;
+    Uint64 total = 0;
+    for (std::size_t i = 0; i < MEMORY_CATEGORIES; i++) {
+        report += std::format(
+            "  {:<9} {:8.2f} MB\n",
+            memoryCategoryName(static_cast<MemoryCategory>(i)),
+            static_cast<double>(stats.category_bytes[i]) / MEMORY_MB);
+        total += stats.category_bytes[i];
+    }
+    report += std::format("  {:<9} {:8.2f} MB\n", "assets",
+                          static_cast<double>(total) / MEMORY_MB);
+
+    if (MEMORY_HEAP_TRACKED) {
+        report += std::format(
+            "  {:<9} {:8.2f} MB live, {:.2f} MB peak, {} allocations\n",
+            "heap", static_cast<double>(stats.heap_bytes) / MEMORY_MB,
+            static_cast<double>(stats.heap_peak) / MEMORY_MB,
+            stats.allocations);
+    }
+    return report;
+}
+
+#if MEMORY_HOOKS
+
+// Every block starts with a header holding its size, so delete knows what
+// to take off the live count whether or not the sized overload is called.
+// The header keeps the alignment malloc gives. Over-aligned allocations go
+// through the library's aligned operators and are not counted.
+constexpr std::size_t MEMORY_HEADER = alignof(std::max_align_t);
+
+static void *trackedAlloc(std::size_t size) {
+    void *block = std::malloc(size + MEMORY_HEADER);
+    if (!block) {
+        return nullptr;
+    }
+    *static_cast<std::size_t *>(block) = size;
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    Uint64 live =
+        heap_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    Uint64 peak = heap_peak.load(std::memory_order_relaxed);
+    while (live > peak && !heap_peak.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed)) {
+    }
+    return static_cast<std::byte *>(block) + MEMORY_HEADER;
+}
+
+static void trackedFree(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    void *block = static_cast<std::byte *>(ptr) - MEMORY_HEADER;
+    heap_bytes.fetch_sub(*static_cast<std::size_t *>(block),
+                         std::memory_order_relaxed);
+    std::free(block);
+}
+
+void *operator new(std::size_t size) {
+    void *ptr = trackedAlloc(size);
+    if (!ptr) {
+        throw std::bad_alloc{};
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return trackedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return trackedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, std::size_t) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    trackedFree(ptr);
+}
+
+#endif
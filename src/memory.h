@@ -0,0 +1,51 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "main.h"
+#include <array>
+#include <string>
+
+// Counting heap allocations replaces the global operator new and delete and
+// costs a few atomic adds on each of them, so only debug and profile builds
+// pay for it.
+#if defined(DEBUG) || defined(PROFILE)
+#define MEMORY_HOOKS 1
+#else
+#define MEMORY_HOOKS 0
+#endif
+
+constexpr bool MEMORY_HEAP_TRACKED = MEMORY_HOOKS != 0;
+
+constexpr double MEMORY_MB = 1024.0 * 1024.0;
+
+enum class MemoryCategory : Uint8 { Textures, Surfaces, Audio, Fonts };
+constexpr std::size_t MEMORY_CATEGORIES = 4;
+
+// Category bytes are whatever the owner last reported. The heap counters
+// are zero unless MEMORY_HEAP_TRACKED.
+struct MemoryStats {
+        std::array<Uint64, MEMORY_CATEGORIES> category_bytes;
+        Uint64 heap_bytes;
+        Uint64 heap_peak;
+        Uint64 allocations;
+        Uint64 frame_allocations;
+};
+
+// The bytes an asset category holds right now, replacing the last report.
+// Owners recount after loading or reloading instead of adding and removing
+// on every allocation, so a missed release can not drift the total.
+void memorySetCategory(MemoryCategory category, Uint64 bytes);
+
+// Ends a frame, the allocations made on any thread since the previous call
+// become the frame's count.
+void memoryFrame();
+
+MemoryStats memoryStats();
+Uint64 memoryTextureBytes(const SDL_Texture *texture);
+Uint64 memorySurfaceBytes(const SDL_Surface *surface);
+const char *memoryCategoryName(MemoryCategory category);
+
+// One line per category plus the heap counters when they are tracked.
+std::string memoryReport();
+
+#endif
@@ -0,0 +1,255 @@
+#include "particles.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : count{0},
+      gen{},
+      pos_x(capacity),
+      pos_y(capacity),
+      vel_x(capacity),
+      vel_y(capacity),
+      life(capacity),
+      inv_life(capacity),
+      red(capacity),
+      green(capacity),
+      blue(capacity),
+      indices(capacity * 6) {
+    // The index buffer never changes, quad i always uses vertices 4i..4i+3.
+    // Sharing corners lets the software renderer recognise each quad as an
+    // axis aligned rect and fill it directly instead of as two triangles.
+    for (std::size_t i = 0; i < capacity; i++) {
+        int v = static_cast<int>(i * 4);
+        int *quad = &this->indices[i * 6];
+        quad[0] = v;
+        quad[1] = v + 1;
+        quad[2] = v + 2;
+        quad[3] = v + 2;
+        quad[4] = v + 3;
+        quad[5] = v;
+    }
+}
+
+void ParticleSystem::seed(Uint64 seed) { this->gen.seed(seed); }
+
+void ParticleSystem::emit(float x, float y, std::size_t amount,
+                          SDL_Color color) {
+    const float r = static_cast<float>(color.r) / 255.0f;
+    const float g = static_cast<float>(color.g) / 255.0f;
+    const float b = static_cast<float>(color.b) / 255.0f;
+
+    amount = std::min(amount, this->capacity() - this->count);
+
+    // The random angle, speed and lifetime are bulk filled straight into the
+    // velocity and life arrays, then turned into real values in place. With
+    // a full pool first is one past the end, which only data() may point at.
+    const std::size_t first = this->count;
+    this->gen.fill(this->vel_x.data() + first, amount, 0,
+                   2 * std::numbers::pi_v<float>);
+    this->gen.fill(this->vel_y.data() + first, amount, PARTICLE_SPEED_MIN,
+                   PARTICLE_SPEED_MAX);
+    this->gen.fill(this->life.data() + first, amount, PARTICLE_LIFE_MIN,
+                   PARTICLE_LIFE_MAX);
+
+    for (std::size_t i = first; i < first + amount; i++) {
+        float angle = this->vel_x[i];
+        float speed = this->vel_y[i];
+
+        this->pos_x[i] = x;
+        this->pos_y[i] = y;
+        this->vel_x[i] = std::cos(angle) * speed;
+        this->vel_y[i] = std::sin(angle) * speed;
+        this->inv_life[i] = 1.0f / this->life[i];
+        this->red[i] = r;
+        this->green[i] = g;
+        this->blue[i] = b;
+    }
+
+    this->count += amount;
+}
+
+void ParticleSystem::update(float dt) {
+    this->integrate(dt);
+    this->compact();
+}
+
+void ParticleSystem::integrate(float dt) {
+    const float damp = 1.0f / (1.0f + PARTICLE_DRAG * dt);
+    const float gravity = PARTICLE_GRAVITY * dt;
+
+    float *__restrict px = this->pos_x.data();
+    float *__restrict py = this->pos_y.data();
+    float *__restrict vx = this->vel_x.data();
+    float *__restrict vy = this->vel_y.data();
+    float *__restrict lf = this->life.data();
+
+    for (std::size_t i = 0; i < this->count; i++) {
+        vx[i] *= damp;
+        vy[i] = (vy[i] + gravity) * damp;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        lf[i] -= dt;
+    }
+}
+
+void ParticleSystem::compact() {
+    std::size_t i = 0;
+    while (i < this->count) {
+        if (this->life[i] > 0) {
+            i++;
+            continue;
+        }
+
+        this->count--;
+        std::size_t last = this->count;
+        this->pos_x[i] = this->pos_x[last];
+        this->pos_y[i] = this->pos_y[last];
+        this->vel_x[i] = this->vel_x[last];
+        this->vel_y[i] = this->vel_y[last];
+        this->life[i] = this->life[last];
+        this->inv_life[i] = this->inv_life[last];
+        this->red[i] = this->red[last];
+        this->green[i] = this->green[last];
+        this->blue[i] = this->blue[last];
+    }
+}
+
+void ParticleSystem::batch(const Camera &camera,
+                           ParticleVertices &vertices) const {
+    constexpr float half = PARTICLE_SIZE / 2;
+
+    const SDL_FRect &view = camera.view();
+    const float scale = camera.zoom();
+    const float min_x = view.x - half;
+    const float min_y = view.y - half;
+    const float max_x = view.x + view.w + half;
+    const float max_y = view.y + view.h + half;
+    const float size = half * scale;
+
+    const float *__restrict px = this->pos_x.data();
+    const float *__restrict py = this->pos_y.data();
+    const float *__restrict lf = this->life.data();
+    const float *__restrict il = this->inv_life.data();
+    float *__restrict xy = vertices.xy.data();
+    SDL_FColor *__restrict colors = vertices.colors.data();
+
+    // Visible particles are packed to the front of the vertex buffer.
+    std::size_t quad = 0;
+    for (std::size_t i = 0; i < this->count; i++) {
+        if (px[i] < min_x || px[i] > max_x || py[i] < min_y ||
+            py[i] > max_y) {
+            continue;
+        }
+
+        float x = (px[i] - view.x) * scale;
+        float y = (py[i] - view.y) * scale;
+        float left = x - size;
+        float right = x + size;
+        float top = y - size;
+        float bottom = y + size;
+
+        xy[quad * 8 + 0] = left;
+        xy[quad * 8 + 1] = top;
+        xy[quad * 8 + 2] = right;
+        xy[quad * 8 + 3] = top;
+        xy[quad * 8 + 4] = right;
+        xy[quad * 8 + 5] = bottom;
+        xy[quad * 8 + 6] = left;
+        xy[quad * 8 + 7] = bottom;
+
+        SDL_FColor color = {this->red[i], this->green[i], this->blue[i],
+                            lf[i] * il[i]};
+        colors[quad * 4 + 0] = color;
+        colors[quad * 4 + 1] = color;
+        colors[quad * 4 + 2] = color;
+        colors[quad * 4 + 3] = color;
+
+        quad++;
+    }
+
+    vertices.quads = quad;
+    vertices.culled = this->count - quad;
+}
+
+void ParticleSystem::draw(SDL_Renderer *renderer,
+                          const ParticleVertices &vertices) const {
+    if (vertices.quads == 0) {
+        return;
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometryRaw(renderer, nullptr, vertices.xy.data(),
+                          2 * sizeof(float), vertices.colors.data(),
+                          sizeof(SDL_FColor), nullptr, 0,
+                          static_cast<int>(vertices.quads * 4),
+                          this->indices.data(),
+                          static_cast<int>(vertices.quads * 6), sizeof(int));
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+void ParticleSystem::record(CommandBuffer &commands,
+                            const ParticleVertices &vertices) const {
+    commands.addGeometry(RenderLayer::Particles, nullptr, SDL_BLENDMODE_BLEND,
+                         vertices.xy.data(), vertices.colors.data(), nullptr,
+                         static_cast<int>(vertices.quads * 4),
+                         this->indices.data(),
+                         static_cast<int>(vertices.quads * 6));
+}
+
+void ParticleSystem::clear() { this->count = 0; }
+
+// Only the live particles are stored, each array as one block, so saving
+// and loading cost a memcpy per array.
+void ParticleSystem::save(SnapshotWriter &writer) const {
+    writer.write(this->gen.state());
+    writer.write(static_cast<Uint64>(this->count));
+    for (const std::vector<float> *array :
+         {&this->pos_x, &this->pos_y, &this->vel_x, &this->vel_y, &this->life,
+          &this->inv_life, &this->red, &this->green, &this->blue}) {
+        writer.writeArray(array->data(), this->count);
+    }
+}
+
+void ParticleSystem::load(SnapshotReader &reader) {
+    std::array<Uint32, RANDOM_LANES * 4> gen_state;
+    reader.read(gen_state);
+
+    Uint64 saved_count = 0;
+    reader.read(saved_count);
+    this->checkCount(saved_count);
+
+    for (std::vector<float> *array :
+         {&this->pos_x, &this->pos_y, &this->vel_x, &this->vel_y, &this->life,
+          &this->inv_life, &this->red, &this->green, &this->blue}) {
+        reader.readArray(array->data(), saved_count);
+    }
+
+    this->gen.setState(gen_state);
+    this->count = saved_count;
+}
+
+// Moves past what load() would read and throws where load() would, without
+// changing the system. The arrays and indices stay where they are, frames
+// still in flight keep pointing at valid memory.
+void ParticleSystem::check(SnapshotReader &reader) const {
+    reader.skip<Uint32>(RANDOM_LANES * 4);
+
+    Uint64 saved_count = 0;
+    reader.read(saved_count);
+    this->checkCount(saved_count);
+    for ([[maybe_unused]] const std::vector<float> *array :
+         {&this->pos_x, &this->pos_y, &this->vel_x, &this->vel_y, &this->life,
+          &this->inv_life, &this->red, &this->green, &this->blue}) {
+        reader.skip<float>(saved_count);
+    }
+}
+
+void ParticleSystem::checkCount(Uint64 saved_count) const {
+    if (saved_count > this->capacity()) {
+        auto error = std::format("Error reading Snapshot: {} particles over "
+                                 "capacity {}",
+                                 saved_count, this->capacity());
+        throw std::runtime_error(error);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "command_buffer.h"
+#include "random.h"
+#include "snapshot.h"
+#include <vector>
+
+constexpr std::size_t PARTICLE_CAPACITY = 20000;
+constexpr std::size_t PARTICLE_BURST = 200;
+constexpr float PARTICLE_GRAVITY = 400;
+constexpr float PARTICLE_DRAG = 1.5f;
+constexpr float PARTICLE_SIZE = 3;
+constexpr float PARTICLE_SPEED_MIN = 50;
+constexpr float PARTICLE_SPEED_MAX = 250;
+constexpr float PARTICLE_LIFE_MIN = 0.5f;
+constexpr float PARTICLE_LIFE_MAX = 1.5f;
+
+// Screen space quads for the visible particles of one frame. They are kept
+// apart from the simulation so a finished frame can be drawn while the next
+// one is being simulated.
+struct ParticleVertices {
+        explicit ParticleVertices(std::size_t capacity = PARTICLE_CAPACITY)
+            : xy(capacity * 8),
+              colors(capacity * 4),
+              quads{0},
+              culled{0} {}
+
+        std::vector<float> xy;
+        std::vector<SDL_FColor> colors;
+        std::size_t quads;
+        std::size_t culled;
+};
+
+// Particles are stored as structure-of-arrays so integrate() and batch() are
+// plain loops over contiguous floats that the compiler can vectorize. Every
+// live particle becomes one colored quad and the whole system is submitted
+// with a single SDL_RenderGeometryRaw call. batch() culls particles outside
+// the camera view while it writes the vertices.
+class ParticleSystem {
+    public:
+        explicit ParticleSystem(std::size_t capacity = PARTICLE_CAPACITY);
+
+        void seed(Uint64 seed);
+        void emit(float x, float y, std::size_t amount, SDL_Color color);
+        void update(float dt);
+        void batch(const Camera &camera, ParticleVertices &vertices) const;
+        void draw(SDL_Renderer *renderer,
+                  const ParticleVertices &vertices) const;
+        void record(CommandBuffer &commands,
+                    const ParticleVertices &vertices) const;
+        void clear();
+        void save(SnapshotWriter &writer) const;
+        void load(SnapshotReader &reader);
+        void check(SnapshotReader &reader) const;
+
+        std::size_t size() const { return this->count; }
+        std::size_t capacity() const { return this->pos_x.size(); }
+
+    private:
+        void integrate(float dt);
+        void compact();
+        void checkCount(Uint64 saved_count) const;
+
+        std::size_t count;
+        RandomBulk gen;
+
+        std::vector<float> pos_x;
+        std::vector<float> pos_y;
+        std::vector<float> vel_x;
+        std::vector<float> vel_y;
+        std::vector<float> life;
+        std::vector<float> inv_life;
+        std::vector<float> red;
+        std::vector<float> green;
+        std::vector<float> blue;
+
+        std::vector<int> indices;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "random.h"
+
+static constexpr Uint32 rotl(Uint32 x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+Uint64 splitMix64(Uint64 &state) {
+    Uint64 z = (state += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+Xoshiro256::Xoshiro256(Uint64 seed) : s{} { this->seed(seed); }
+
+Xoshiro256 Xoshiro256::stream(Uint64 seed, Uint64 index) {
+    Xoshiro256 gen{seed};
+    for (Uint64 i = 0; i < index; i++) {
+        gen.jump();
+    }
+    return gen;
+}
+
+void Xoshiro256::seed(Uint64 seed) {
+    for (Uint64 &word : this->s) {
+        word = splitMix64(seed);
+    }
+}
+
+void Xoshiro256::jump() {
+    constexpr std::array<Uint64, 4> JUMP = {
+        0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA,
+        0x39ABDC4529B1661C};
+
+    std::array<Uint64, 4> jumped{};
+    for (Uint64 word : JUMP) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & Uint64{1} << bit) {
+                for (std::size_t i = 0; i < 4; i++) {
+                    jumped[i] ^= this->s[i];
+                }
+            }
+            (*this)();
+        }
+    }
+    this->s = jumped;
+}
+
+void Xoshiro256::setState(const std::array<Uint64, 4> &state) {
+    this->s = state;
+}
+
+RandomBulk::RandomBulk(Uint64 seed) : s0{}, s1{}, s2{}, s3{} {
+    this->seed(seed);
+}
+
+void RandomBulk::seed(Uint64 seed) {
+    for (std::size_t lane = 0; lane < RANDOM_LANES; lane++) {
+        Uint64 a = splitMix64(seed);
+        Uint64 b = splitMix64(seed);
+        this->s0[lane] = static_cast<Uint32>(a);
+        this->s1[lane] = static_cast<Uint32>(a >> 32);
+        this->s2[lane] = static_cast<Uint32>(b);
+        this->s3[lane] = static_cast<Uint32>(b >> 32) | 1;
+    }
+}
+
+void RandomBulk::next(float *out, float min, float scale) {
+    for (std::size_t lane = 0; lane < RANDOM_LANES; lane++) {
+        const Uint32 result = this->s0[lane] + this->s3[lane];
+        const Uint32 t = this->s1[lane] << 9;
+
+        this->s2[lane] ^= this->s0[lane];
+        this->s3[lane] ^= this->s1[lane];
+        this->s1[lane] ^= this->s2[lane];
+        this->s0[lane] ^= this->s3[lane];
+        this->s2[lane] ^= t;
+        this->s3[lane] = rotl(this->s3[lane], 11);
+
+        out[lane] = min + static_cast<float>(result >> 8) * scale;
+    }
+}
+
+void RandomBulk::fill(float *out, std::size_t count, float min, float max) {
+    const float scale = (max - min) * RANDOM_FLOAT_UNIT;
+
+    std::size_t i = 0;
+    for (; i + RANDOM_LANES <= count; i += RANDOM_LANES) {
+        this->next(out + i, min, scale);
+    }
+
+    if (i < count) {
+        std::array<float, RANDOM_LANES> tail;
+        this->next(tail.data(), min, scale);
+        std::copy(tail.begin(), tail.begin() + static_cast<long>(count - i),
+                  out + i);
+    }
+}
+
+std::array<Uint32, RANDOM_LANES * 4> RandomBulk::state() const {
+    std::array<Uint32, RANDOM_LANES * 4> state;
+    std::copy(this->s0.begin(), this->s0.end(), state.begin());
+    std::copy(this->s1.begin(), this->s1.end(), state.begin() + RANDOM_LANES);
+    std::copy(this->s2.begin(), this->s2.end(),
+              state.begin() + RANDOM_LANES * 2);
+    std::copy(this->s3.begin(), this->s3.end(),
+              state.begin() + RANDOM_LANES * 3);
+    return state;
+}
+
+void RandomBulk::setState(const std::array<Uint32, RANDOM_LANES * 4> &state) {
+    auto lanes = state.begin();
+    std::copy(lanes, lanes + RANDOM_LANES, this->s0.begin());
+    std::copy(lanes + RANDOM_LANES, lanes + RANDOM_LANES * 2,
+              this->s1.begin());
+    std::copy(lanes + RANDOM_LANES * 2, lanes + RANDOM_LANES * 3,
+              this->s2.begin());
+    std::copy(lanes + RANDOM_LANES * 3, lanes + RANDOM_LANES * 4,
+              this->s3.begin());
+}
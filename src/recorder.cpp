@@ -0,0 +1,152 @@
+#include "recorder.h"
+#include "trace.h"
+#include <string>
+
+VideoRecorder::VideoRecorder()
+    : width{0},
+      height{0},
+      file{nullptr, SDL_CloseIO},
+      pool{},
+      mutex{},
+      ready{},
+      free_buffers{},
+      free_count{0},
+      filled{},
+      filled_head{0},
+      filled_count{0},
+      recorded{0},
+      written{0},
+      dropped{0},
+      failed{0},
+      worker{} {}
+
+// The encoder drains the queue before it returns, so the file is complete
+// when it is closed.
+VideoRecorder::~VideoRecorder() {
+    if (this->worker.joinable()) {
+        this->worker.request_stop();
+        this->worker.join();
+    }
+}
+
+void VideoRecorder::start(SDL_Renderer *renderer, const char *path, int fps) {
+    int output_w = 0;
+    int output_h = 0;
+    if (!SDL_GetRenderOutputSize(renderer, &output_w, &output_h)) {
+        auto error =
+            std::format("Error getting output size: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    // 4:2:0 chroma covers 2x2 pixels, so an odd last row or column is cut.
+    this->width = output_w & ~1;
+    this->height = output_h & ~1;
+
+    this->file.reset(SDL_IOFromFile(path, "wb"));
+    if (!this->file) {
+        auto error = std::format("Error opening {}: {}", path, SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    std::string header = std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 "
+                                     "C420jpeg\n",
+                                     this->width, this->height, fps);
+    if (SDL_WriteIO(this->file.get(), header.data(), header.size()) !=
+        header.size()) {
+        auto error = std::format("Error writing {}: {}", path, SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    std::size_t luma = static_cast<std::size_t>(this->width) *
+                       static_cast<std::size_t>(this->height);
+    this->pool.assign(RECORD_POOL_SIZE, std::vector<Uint8>(luma * 3 / 2));
+    for (std::size_t i = 0; i < RECORD_POOL_SIZE; i++) {
+        this->free_buffers[i] = i;
+    }
+    this->free_count = RECORD_POOL_SIZE;
+
+    this->worker = std::jthread{
+        [this](std::stop_token stop) { this->encode(stop); }};
+}
+
+// Call after everything is drawn and before SDL_RenderPresent.
+void VideoRecorder::frame(SDL_Renderer *renderer) {
+    if (!this->active()) {
+        return;
+    }
+
+    std::unique_lock lock{this->mutex};
+    if (this->free_count == 0) {
+        this->dropped++;
+        return;
+    }
+    std::size_t buffer = this->free_buffers[--this->free_count];
+    lock.unlock();
+
+    std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surface{
+        SDL_RenderReadPixels(renderer, nullptr), SDL_DestroySurface};
+    // The video keeps the size it started with, frames from a resized
+    // window would not fit and are dropped.
+    if (surface && ((surface->w & ~1) != this->width ||
+                    (surface->h & ~1) != this->height)) {
+        this->dropped++;
+        this->release(buffer);
+        return;
+    }
+    if (!surface ||
+        !SDL_ConvertPixels(this->width, this->height, surface->format,
+                           surface->pixels, surface->pitch,
+                           SDL_PIXELFORMAT_IYUV, this->pool[buffer].data(),
+                           this->width)) {
+        this->failed++;
+        this->release(buffer);
+        return;
+    }
+    this->recorded++;
+
+    lock.lock();
+    this->filled[(this->filled_head + this->filled_count) % RECORD_POOL_SIZE] =
+        buffer;
+    this->filled_count++;
+    lock.unlock();
+    this->ready.notify_one();
+}
+
+void VideoRecorder::release(std::size_t buffer) {
+    std::lock_guard lock{this->mutex};
+    this->free_buffers[this->free_count++] = buffer;
+}
+
+void VideoRecorder::encode(std::stop_token stop) {
+    static constexpr char FRAME_HEADER[] = "FRAME\n";
+    traceThreadName("recorder");
+
+    while (true) {
+        std::unique_lock lock{this->mutex};
+        this->ready.wait(lock, stop, [this] { return this->filled_count > 0; });
+        if (this->filled_count == 0) {
+            return;
+        }
+        std::size_t buffer = this->filled[this->filled_head];
+        this->filled_head = (this->filled_head + 1) % RECORD_POOL_SIZE;
+        this->filled_count--;
+        lock.unlock();
+
+        TraceScope scope{"writeFrame"};
+        const std::vector<Uint8> &pixels = this->pool[buffer];
+        if (SDL_WriteIO(this->file.get(), FRAME_HEADER,
+                        sizeof(FRAME_HEADER) - 1) == sizeof(FRAME_HEADER) - 1 &&
+            SDL_WriteIO(this->file.get(), pixels.data(), pixels.size()) ==
+                pixels.size()) {
+            this->written++;
+        } else {
+            this->failed++;
+        }
+
+        this->release(buffer);
+    }
+}
+
+RecordStats VideoRecorder::stats() const {
+    return {this->recorded.load(), this->written.load(), this->dropped.load(),
+            this->failed.load()};
+}
@@ -0,0 +1,70 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "main.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t RECORD_POOL_SIZE = 6;
+constexpr int RECORD_FPS = 60;
+
+struct RecordStats {
+        Uint64 recorded;
+        Uint64 written;
+        Uint64 dropped;
+        Uint64 failed;
+};
+
+// Streams every frame into a Y4M video. Frames are read back on the render
+// thread, converted straight into one of RECORD_POOL_SIZE preallocated I420
+// buffers and queued for a worker thread that writes them out and hands the
+// buffer back. The pool and both queues are fixed size, so nothing is
+// allocated per frame apart from the surface SDL_RenderReadPixels returns.
+// When every buffer is waiting on the encoder the frame is dropped and
+// counted instead of blocking the game, as are frames read back after the
+// window changed size.
+class VideoRecorder {
+    public:
+        VideoRecorder();
+        ~VideoRecorder();
+
+        VideoRecorder(const VideoRecorder &) = delete;
+        VideoRecorder &operator=(const VideoRecorder &) = delete;
+
+        void start(SDL_Renderer *renderer, const char *path, int fps);
+        void frame(SDL_Renderer *renderer);
+
+        bool active() const { return this->file != nullptr; }
+        RecordStats stats() const;
+
+    private:
+        void encode(std::stop_token stop);
+        void release(std::size_t buffer);
+
+        int width;
+        int height;
+        std::unique_ptr<SDL_IOStream, decltype(&SDL_CloseIO)> file;
+        std::vector<std::vector<Uint8>> pool;
+
+        std::mutex mutex;
+        std::condition_variable_any ready;
+        std::array<std::size_t, RECORD_POOL_SIZE> free_buffers;
+        std::size_t free_count;
+        std::array<std::size_t, RECORD_POOL_SIZE> filled;
+        std::size_t filled_head;
+        std::size_t filled_count;
+
+        std::atomic<Uint64> recorded;
+        std::atomic<Uint64> written;
+        std::atomic<Uint64> dropped;
+        std::atomic<Uint64> failed;
+
+        std::jthread worker;
+};
+
+#endif
@@ -0,0 +1,379 @@
+#include "scene.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+constexpr std::size_t SCENE_MAX_FIELDS = 13;
+
+std::size_t Scene::find(std::string_view name) const {
+    for (std::size_t i = 0; i < this->assets.size(); i++) {
+        if (this->assets[i].name == name) {
+            return i;
+        }
+    }
+    return SCENE_NONE;
+}
+
+std::size_t Scene::findPath(std::string_view path) const {
+    for (std::size_t i = 0; i < this->assets.size(); i++) {
+        if (this->assets[i].kind != AssetKind::Text &&
+            this->assets[i].kind != AssetKind::Animation &&
+            this->assets[i].path == path) {
+            return i;
+        }
+    }
+    return SCENE_NONE;
+}
+
+std::size_t Scene::findAnimation(std::size_t asset) const {
+    for (std::size_t i = 0; i < this->animations.size(); i++) {
+        if (this->animations[i].asset == asset) {
+            return i;
+        }
+    }
+    return SCENE_NONE;
+}
+
+// Splits scene text into lines and lines into fields without copying. A
+// field is a run of non-space characters or a double quoted string, a #
+// outside quotes starts a comment.
+class SceneParser {
+    public:
+        SceneParser(std::string_view scene_text, std::string_view source_name)
+            : text{scene_text},
+              source{source_name},
+              line{0},
+              fields{},
+              count{0} {}
+
+        bool next();
+        void parse(Scene &scene);
+
+    private:
+        [[noreturn]] void fail(std::string_view message) const;
+        void expect(std::size_t expected) const;
+        float number(std::size_t index) const;
+        int integer(std::size_t index) const;
+        Uint8 channel(std::size_t index) const;
+        std::size_t asset(const Scene &scene, std::size_t index,
+                          AssetKind kind) const;
+        void addAsset(Scene &scene, SceneAsset asset) const;
+        void addTiles(Scene &scene) const;
+
+        std::string_view text;
+        std::string_view source;
+        int line;
+        std::array<std::string_view, SCENE_MAX_FIELDS> fields;
+        std::size_t count;
+};
+
+void SceneParser::fail(std::string_view message) const {
+    auto error = std::format("{}:{}: {}", this->source, this->line, message);
+    throw std::runtime_error(error);
+}
+
+bool SceneParser::next() {
+    while (!this->text.empty()) {
+        std::size_t end = this->text.find('\n');
+        std::string_view current = this->text.substr(0, end);
+        this->text.remove_prefix(
+            end == std::string_view::npos ? this->text.size() : end + 1);
+        this->line++;
+
+        this->count = 0;
+        std::size_t i = 0;
+        while (i < current.size()) {
+            char c = current[i];
+            if (c == ' ' || c == '\t' || c == '\r') {
+                i++;
+                continue;
+            }
+            if (c == '#') {
+                break;
+            }
+            if (this->count == SCENE_MAX_FIELDS) {
+                this->fail("too many fields");
+            }
+
+            std::size_t start = i;
+            if (c == '"') {
+                std::size_t close = current.find('"', i + 1);
+                if (close == std::string_view::npos) {
+                    this->fail("unterminated string");
+                }
+                this->fields[this->count++] =
+                    current.substr(start + 1, close - start - 1);
+                i = close + 1;
+            } else {
+                while (i < current.size() && current[i] != ' ' &&
+                       current[i] != '\t' && current[i] != '\r') {
+                    i++;
+                }
+                this->fields[this->count++] = current.substr(start, i - start);
+            }
+        }
+
+        if (this->count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SceneParser::expect(std::size_t expected) const {
+    if (this->count != expected) {
+        this->fail(std::format("{} takes {} fields", this->fields[0],
+                               expected - 1));
+    }
+}
+
+float SceneParser::number(std::size_t index) const {
+    std::string_view field = this->fields[index];
+    float value = 0;
+    auto [end, ec] =
+        std::from_chars(field.data(), field.data() + field.size(), value);
+    // from_chars also reads inf and nan, which no field has a use for and
+    // which slip through range checks.
+    if (ec != std::errc{} || end != field.data() + field.size() ||
+        !std::isfinite(value)) {
+        this->fail(std::format("invalid number {}", field));
+    }
+    return value;
+}
+
+// Sizes and counts, truncated like a cast but only within the range of int.
+int SceneParser::integer(std::size_t index) const {
+    float value = this->number(index);
+    if (value <= static_cast<float>(std::numeric_limits<int>::min()) ||
+        value >= static_cast<float>(std::numeric_limits<int>::max())) {
+        this->fail(std::format("number {} out of range", this->fields[index]));
+    }
+    return static_cast<int>(value);
+}
+
+Uint8 SceneParser::channel(std::size_t index) const {
+    float value = this->number(index);
+    if (value < 0 || value > 255) {
+        this->fail(std::format("color {} out of range", value));
+    }
+    return static_cast<Uint8>(value);
+}
+
+std::size_t SceneParser::asset(const Scene &scene, std::size_t index,
+                               AssetKind kind) const {
+    std::size_t found = scene.find(this->fields[index]);
+    if (found == SCENE_NONE) {
+        this->fail(std::format("unknown asset {}", this->fields[index]));
+    }
+    // Anything drawn can stand in for an image.
+    AssetKind found_kind = scene.assets[found].kind;
+    if (found_kind != kind &&
+        !(kind == AssetKind::Image && (found_kind == AssetKind::Text ||
+                                       found_kind == AssetKind::Animation))) {
+        this->fail(std::format("asset {} has the wrong kind",
+                               this->fields[index]));
+    }
+    return found;
+}
+
+void SceneParser::addAsset(Scene &scene, SceneAsset asset) const {
+    if (scene.find(asset.name) != SCENE_NONE) {
+        this->fail(std::format("asset {} defined twice", asset.name));
+    }
+    scene.assets.push_back(std::move(asset));
+}
+
+// Fills rows first to last with the same run of tiles from column 0, one
+// character per tile: . for empty, 1 to 9 and then a to z for tiles 1 to 35.
+void SceneParser::addTiles(Scene &scene) const {
+    SceneTilemap &tilemap = scene.tilemap;
+    if (tilemap.image == SCENE_NONE) {
+        this->fail("tiles before tilemap");
+    }
+    int first = this->integer(1);
+    int last = this->integer(2);
+    std::string_view row = this->fields[3];
+    if (first < 0 || last < first || last >= tilemap.rows) {
+        this->fail(std::format("tile rows {} to {} outside the tilemap",
+                               this->fields[1], this->fields[2]));
+    }
+    if (row.size() > static_cast<std::size_t>(tilemap.columns)) {
+        this->fail("tile row longer than the tilemap");
+    }
+
+    for (std::size_t x = 0; x < row.size(); x++) {
+        char c = row[x];
+        Uint16 tile = 0;
+        if (c >= '1' && c <= '9') {
+            tile = static_cast<Uint16>(c - '0');
+        } else if (c >= 'a' && c <= 'z') {
+            tile = static_cast<Uint16>(c - 'a' + 10);
+        } else if (c != '.') {
+            this->fail(std::format("invalid tile {}", c));
+        }
+        for (int y = first; y <= last; y++) {
+            std::size_t columns = static_cast<std::size_t>(tilemap.columns);
+            tilemap.tiles[static_cast<std::size_t>(y) * columns + x] = tile;
+        }
+    }
+}
+
+void SceneParser::parse(Scene &scene) {
+    while (this->next()) {
+        std::string_view keyword = this->fields[0];
+
+        if (keyword == "entity") {
+            // The spin, scale and tint fields are optional as a group.
+            if (this->count != 13) {
+                this->expect(7);
+            }
+            std::string_view behavior = this->fields[2];
+            Behavior kind = Behavior::Static;
+            if (behavior == "bounce") {
+                kind = Behavior::Bounce;
+            } else if (behavior == "player") {
+                kind = Behavior::Player;
+            } else if (behavior != "static") {
+                this->fail(std::format("unknown behavior {}", behavior));
+            }
+
+            std::size_t sprite = this->asset(scene, 1, AssetKind::Image);
+            float spin = 0;
+            float scale = 1;
+            SDL_Color tint{255, 255, 255, 255};
+            if (this->count == 13) {
+                if (scene.assets[sprite].kind == AssetKind::Text) {
+                    this->fail("texts can not be turned, scaled or tinted");
+                }
+                spin = this->number(7);
+                scale = this->number(8);
+                tint = {this->channel(9), this->channel(10),
+                        this->channel(11), this->channel(12)};
+                if (scale <= 0) {
+                    this->fail("entity scale must be positive");
+                }
+            }
+
+            SceneEntities &entities = scene.entities;
+            entities.sprite.push_back(static_cast<Uint32>(sprite));
+            entities.behavior.push_back(kind);
+            entities.x.push_back(this->number(3));
+            entities.y.push_back(this->number(4));
+            entities.speed_x.push_back(this->number(5));
+            entities.speed_y.push_back(this->number(6));
+            entities.spin.push_back(spin);
+            entities.scale.push_back(scale);
+            entities.tint.push_back(tint);
+        } else if (keyword == "window") {
+            this->expect(4);
+            scene.window_w = this->integer(1);
+            scene.window_h = this->integer(2);
+            scene.title = this->fields[3];
+            if (scene.window_w <= 0 || scene.window_h <= 0) {
+                this->fail("window size must be positive");
+            }
+        } else if (keyword == "tilemap") {
+            this->expect(4);
+            if (scene.tilemap.image != SCENE_NONE) {
+                this->fail("tilemap defined twice");
+            }
+            std::size_t image = this->asset(scene, 1, AssetKind::Image);
+            int columns = this->integer(2);
+            int rows = this->integer(3);
+            if (scene.assets[image].kind != AssetKind::Image) {
+                this->fail("tilemaps are cut from an image");
+            }
+            if (columns <= 0 || rows <= 0 || columns > SCENE_MAX_TILEMAP ||
+                rows > SCENE_MAX_TILEMAP) {
+                this->fail(std::format("tilemap size must be 1 to {} tiles",
+                                       SCENE_MAX_TILEMAP));
+            }
+            scene.tilemap = {image, columns, rows,
+                             std::vector<Uint16>(
+                                 static_cast<std::size_t>(columns) *
+                                 static_cast<std::size_t>(rows))};
+        } else if (keyword == "tiles") {
+            this->expect(4);
+            this->addTiles(scene);
+        } else if (keyword == "icon") {
+            this->expect(2);
+            scene.icon = this->asset(scene, 1, AssetKind::Image);
+            if (scene.assets[scene.icon].kind != AssetKind::Image) {
+                this->fail("icons are set from an image");
+            }
+        } else if (keyword == "text") {
+            this->expect(8);
+            float size = this->number(3);
+            if (size <= 0) {
+                this->fail("text size must be positive");
+            }
+            this->addAsset(scene,
+                           {AssetKind::Text,
+                            std::string{this->fields[1]},
+                            std::string{this->fields[7]},
+                            this->asset(scene, 2, AssetKind::Font), size,
+                            {this->channel(4), this->channel(5),
+                             this->channel(6), 255}});
+        } else if (keyword == "animation") {
+            this->expect(7);
+            int frames = this->integer(5);
+            SceneAnimation animation{scene.assets.size(),
+                                     this->asset(scene, 2, AssetKind::Image),
+                                     this->integer(3),
+                                     this->integer(4),
+                                     static_cast<Uint32>(frames),
+                                     this->number(6)};
+            if (scene.assets[animation.image].kind != AssetKind::Image) {
+                this->fail("animations are cut from an image");
+            }
+            if (animation.frame_w <= 0 || animation.frame_h <= 0 ||
+                frames < 1 || animation.fps <= 0) {
+                this->fail("animation sizes, frames and fps must be "
+                           "positive");
+            }
+            this->addAsset(scene, {AssetKind::Animation,
+                                   std::string{this->fields[1]},
+                                   {},
+                                   SCENE_NONE,
+                                   0,
+                                   {255, 255, 255, 255}});
+            scene.animations.push_back(animation);
+        } else if (keyword == "image" || keyword == "font" ||
+                   keyword == "sound" || keyword == "music") {
+            this->expect(3);
+            AssetKind kind = keyword == "image"   ? AssetKind::Image
+                             : keyword == "font"  ? AssetKind::Font
+                             : keyword == "sound" ? AssetKind::Sound
+                                                  : AssetKind::Music;
+            this->addAsset(scene, {kind,
+                                   std::string{this->fields[1]},
+                                   std::string{this->fields[2]},
+                                   SCENE_NONE,
+                                   0,
+                                   {255, 255, 255, 255}});
+        } else {
+            this->fail(std::format("unknown keyword {}", keyword));
+        }
+    }
+}
+
+Scene parseScene(std::string_view text, std::string_view source) {
+    Scene scene{WINDOW_WIDTH, WINDOW_HEIGHT, "", SCENE_NONE, {}, {}, {},
+                {SCENE_NONE, 0, 0, {}}};
+    SceneParser parser{text, source};
+    parser.parse(scene);
+    return scene;
+}
+
+Scene loadScene(const char *path) {
+    std::size_t size = 0;
+    std::unique_ptr<void, decltype(&SDL_free)> data{SDL_LoadFile(path, &size),
+                                                    SDL_free};
+    if (!data) {
+        auto error = std::format("Error loading Scene: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    return parseScene({static_cast<const char *>(data.get()), size}, path);
+}
@@ -0,0 +1,85 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "main.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr const char *SCENE_PATH = "scenes/default.scene";
+constexpr std::size_t SCENE_NONE = static_cast<std::size_t>(-1);
+constexpr int SCENE_MAX_TILEMAP = 4096;
+
+enum class AssetKind : Uint8 { Image, Font, Text, Sound, Music, Animation };
+
+// Static entities are drawn behind everything and never move. Bounce
+// entities fly at their speed and bounce off the world edges with a burst
+// of particles, player entities are steered with the keyboard at their
+// speed and the camera follows the first one.
+enum class Behavior : Uint8 { Static, Bounce, Player };
+
+struct SceneAsset {
+        AssetKind kind;
+        std::string name;
+        std::string path;
+        std::size_t font;
+        float size;
+        SDL_Color color;
+};
+
+// One entry per entity in each array, so thousands of entities load as a
+// handful of allocations and the world can copy them straight across.
+struct SceneEntities {
+        std::vector<Uint32> sprite;
+        std::vector<Behavior> behavior;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> speed_x;
+        std::vector<float> speed_y;
+        std::vector<float> spin;
+        std::vector<float> scale;
+        std::vector<SDL_Color> tint;
+
+        std::size_t size() const { return this->sprite.size(); }
+};
+
+// A sprite sheet animation, frames of frame_w by frame_h cut from the image
+// asset row by row. The asset with the animation's name has no path.
+struct SceneAnimation {
+        std::size_t asset;
+        std::size_t image;
+        int frame_w;
+        int frame_h;
+        Uint32 frames;
+        float fps;
+};
+
+// A level of columns by rows tiles cut from the image, stored row by row.
+// Tile 0 is empty, tile n is the nth tile of the image counted left to
+// right, top to bottom. image is SCENE_NONE in scenes without a tilemap.
+struct SceneTilemap {
+        std::size_t image;
+        int columns;
+        int rows;
+        std::vector<Uint16> tiles;
+};
+
+struct Scene {
+        int window_w;
+        int window_h;
+        std::string title;
+        std::size_t icon;
+        std::vector<SceneAsset> assets;
+        SceneEntities entities;
+        std::vector<SceneAnimation> animations;
+        SceneTilemap tilemap;
+
+        std::size_t find(std::string_view name) const;
+        std::size_t findPath(std::string_view path) const;
+        std::size_t findAnimation(std::size_t asset) const;
+};
+
+Scene parseScene(std::string_view text, std::string_view source);
+Scene loadScene(const char *path);
+
+#endif
@@ -0,0 +1,446 @@
+#include "sdf_font.h"
+#include "snapshot.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+constexpr double SDF_FAR = 1e20;
+constexpr Uint8 SDF_INSIDE_ALPHA = 128;
+constexpr SDL_Color SDF_GLYPH_COLOR = {255, 255, 255, 255};
+
+SdfFont::SdfFont()
+    : line_height{0},
+      atlas_w{0},
+      atlas_h{0},
+      from_cache{false},
+      glyphs{},
+      distances{},
+      textures{} {}
+
+std::string sdfCachePath(const std::string &font_path) {
+    std::size_t dot = font_path.rfind('.');
+    std::size_t slash = font_path.rfind('/');
+    if (dot == std::string::npos ||
+        (slash != std::string::npos && dot < slash)) {
+        return font_path + ".sdf";
+    }
+    return font_path.substr(0, dot) + ".sdf";
+}
+
+static Uint64 fontHash(const std::string &font_path) {
+    std::size_t size = 0;
+    std::unique_ptr<void, decltype(&SDL_free)> data{
+        SDL_LoadFile(font_path.c_str(), &size), SDL_free};
+    if (!data) {
+        auto error = std::format("Error loading Font: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    return snapshotHash({static_cast<const std::byte *>(data.get()), size});
+}
+
+// Squared distance to the nearest zero along one row or column, the lower
+// envelope of parabolas from Felzenszwalb and Huttenlocher. Exact and linear
+// in the length of the line.
+static void distanceLine(const double *input, double *output, int length,
+                         int *vertex, double *bound) {
+    int k = 0;
+    vertex[0] = 0;
+    bound[0] = -std::numeric_limits<double>::infinity();
+    bound[1] = std::numeric_limits<double>::infinity();
+    for (int q = 1; q < length; q++) {
+        double s = 0;
+        while (true) {
+            int v = vertex[k];
+            s = ((input[q] + q * q) - (input[v] + v * v)) / (2.0 * (q - v));
+            if (s > bound[k]) {
+                break;
+            }
+            k--;
+        }
+        k++;
+        vertex[k] = q;
+        bound[k] = s;
+        bound[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    k = 0;
+    for (int q = 0; q < length; q++) {
+        while (bound[k + 1] < q) {
+            k++;
+        }
+        double d = q - vertex[k];
+        output[q] = d * d + input[vertex[k]];
+    }
+}
+
+// Cells that are 0 on input hold the squared distance to the nearest 0 cell
+// on output, columns first and then rows.
+static void distanceTransform(std::vector<double> &grid, int width,
+                              int height) {
+    auto longest = static_cast<std::size_t>(std::max(width, height));
+    std::vector<double> line_in(longest);
+    std::vector<double> line_out(longest);
+    std::vector<int> vertex(longest);
+    std::vector<double> bound(longest + 1);
+    auto w = static_cast<std::size_t>(width);
+    auto h = static_cast<std::size_t>(height);
+
+    for (std::size_t x = 0; x < w; x++) {
+        for (std::size_t y = 0; y < h; y++) {
+            line_in[y] = grid[y * w + x];
+        }
+        distanceLine(line_in.data(), line_out.data(), height, vertex.data(),
+                     bound.data());
+        for (std::size_t y = 0; y < h; y++) {
+            grid[y * w + x] = line_out[y];
+        }
+    }
+    for (std::size_t y = 0; y < h; y++) {
+        double *row = grid.data() + y * w;
+        std::copy(row, row + width, line_in.begin());
+        distanceLine(line_in.data(), row, width, vertex.data(), bound.data());
+    }
+}
+
+// Each glyph is rasterized large, its exact distance transform taken both
+// inside and outside the outline, then sampled down at the centre of every
+// atlas pixel. Distances are stored as 0..255 across plus and minus
+// SDF_SPREAD base pixels, the outline sits at 127.5.
+void SdfFont::generate(const std::string &font_path) {
+    constexpr int pad = static_cast<int>(SDF_SPREAD) * SDF_OVERSAMPLE;
+
+    std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> font{
+        TTF_OpenFont(font_path.c_str(), SDF_BASE_SIZE * SDF_OVERSAMPLE),
+        TTF_CloseFont};
+    if (!font) {
+        auto error = std::format("Error creating Font: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->line_height = static_cast<float>(TTF_GetFontHeight(font.get())) /
+                        SDF_OVERSAMPLE;
+    this->glyphs.assign(SDF_LAST_CHAR - SDF_FIRST_CHAR + 1, SdfGlyph{});
+    this->distances.assign(
+        static_cast<std::size_t>(SDF_ATLAS_SIZE) * SDF_ATLAS_SIZE, 0);
+
+    SkylinePacker packer{SDF_ATLAS_SIZE, SDF_ATLAS_SIZE};
+    std::vector<double> inside;
+    std::vector<double> outside;
+    int used_h = 0;
+
+    for (char ch = SDF_FIRST_CHAR; ch <= SDF_LAST_CHAR; ch++) {
+        SdfGlyph &glyph = this->glyphs[static_cast<std::size_t>(
+            ch - SDF_FIRST_CHAR)];
+        auto codepoint = static_cast<Uint32>(ch);
+
+        int min_x = 0;
+        int max_x = 0;
+        int min_y = 0;
+        int max_y = 0;
+        int advance = 0;
+        if (!TTF_GetGlyphMetrics(font.get(), codepoint, &min_x, &max_x,
+                                 &min_y, &max_y, &advance)) {
+            auto error =
+                std::format("Error measuring Glyph: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        glyph.advance = static_cast<float>(advance) / SDF_OVERSAMPLE;
+        if (ch == ' ') {
+            continue;
+        }
+
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> rendered{
+            TTF_RenderGlyph_Blended(font.get(), codepoint, SDF_GLYPH_COLOR),
+            SDL_DestroySurface};
+        if (!rendered) {
+            auto error =
+                std::format("Error rendering Glyph: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surf{
+            SDL_ConvertSurface(rendered.get(), SDL_PIXELFORMAT_ARGB8888),
+            SDL_DestroySurface};
+        if (!surf) {
+            auto error =
+                std::format("Error converting Surface: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+
+        // Padded on every side by the spread and rounded up to whole atlas
+        // pixels.
+        int cell_w = (surf->w + 2 * pad + SDF_OVERSAMPLE - 1) / SDF_OVERSAMPLE;
+        int cell_h = (surf->h + 2 * pad + SDF_OVERSAMPLE - 1) / SDF_OVERSAMPLE;
+        int grid_w = cell_w * SDF_OVERSAMPLE;
+        int grid_h = cell_h * SDF_OVERSAMPLE;
+        auto grid_size = static_cast<std::size_t>(grid_w) *
+                         static_cast<std::size_t>(grid_h);
+        inside.assign(grid_size, SDF_FAR);
+        outside.assign(grid_size, 0);
+
+        for (int y = 0; y < surf->h; y++) {
+            const Uint32 *row = reinterpret_cast<const Uint32 *>(
+                static_cast<const Uint8 *>(surf->pixels) +
+                static_cast<std::ptrdiff_t>(y) * surf->pitch);
+            for (int x = 0; x < surf->w; x++) {
+                if (row[x] >> 24 < SDF_INSIDE_ALPHA) {
+                    continue;
+                }
+                std::size_t cell = static_cast<std::size_t>(y + pad) *
+                                       static_cast<std::size_t>(grid_w) +
+                                   static_cast<std::size_t>(x + pad);
+                inside[cell] = 0;
+                outside[cell] = SDF_FAR;
+            }
+        }
+        distanceTransform(inside, grid_w, grid_h);
+        distanceTransform(outside, grid_w, grid_h);
+
+        SDL_Rect rect;
+        if (!packer.pack(cell_w + 1, cell_h + 1, rect)) {
+            throw std::runtime_error(
+                std::format("Error packing Glyph: {} does not fit", ch));
+        }
+        used_h = std::max(used_h, rect.y + cell_h);
+
+        for (int y = 0; y < cell_h; y++) {
+            for (int x = 0; x < cell_w; x++) {
+                std::size_t cell =
+                    static_cast<std::size_t>(y * SDF_OVERSAMPLE +
+                                             SDF_OVERSAMPLE / 2) *
+                        static_cast<std::size_t>(grid_w) +
+                    static_cast<std::size_t>(x * SDF_OVERSAMPLE +
+                                             SDF_OVERSAMPLE / 2);
+                // Positive inside the outline, in base size pixels.
+                double distance =
+                    inside[cell] <= 0 ? std::sqrt(outside[cell]) - 0.5
+                                      : 0.5 - std::sqrt(inside[cell]);
+                distance /= SDF_OVERSAMPLE;
+                double value = 127.5 + distance / SDF_SPREAD * 127.5;
+                std::size_t pixel =
+                    static_cast<std::size_t>(rect.y + y) * SDF_ATLAS_SIZE +
+                    static_cast<std::size_t>(rect.x + x);
+                this->distances[pixel] =
+                    static_cast<Uint8>(std::clamp(value, 0.0, 255.0) + 0.5);
+            }
+        }
+
+        glyph.rect = {static_cast<float>(rect.x), static_cast<float>(rect.y),
+                      static_cast<float>(cell_w), static_cast<float>(cell_h)};
+        glyph.offset_x = static_cast<float>(std::min(min_x, 0) - pad) /
+                         SDF_OVERSAMPLE;
+        glyph.offset_y = -SDF_SPREAD;
+    }
+
+    // Rows below the last glyph are never sampled, so the atlas is cropped
+    // to the packed height.
+    this->atlas_w = SDF_ATLAS_SIZE;
+    this->atlas_h = std::max(used_h, 1);
+    this->distances.resize(static_cast<std::size_t>(this->atlas_w) *
+                           static_cast<std::size_t>(this->atlas_h));
+}
+
+void SdfFont::write(std::vector<std::byte> &buffer, Uint64 font_hash) const {
+    SnapshotWriter writer{buffer};
+    writer.write(SDF_CACHE_VERSION);
+    writer.write(font_hash);
+    writer.write(SDF_BASE_SIZE);
+    writer.write(SDF_OVERSAMPLE);
+    writer.write(SDF_SPREAD);
+    writer.write(this->line_height);
+    writer.write(this->atlas_w);
+    writer.write(this->atlas_h);
+    writer.write(static_cast<Uint64>(this->glyphs.size()));
+    writer.writeArray(this->glyphs.data(), this->glyphs.size());
+    writer.writeArray(this->distances.data(), this->distances.size());
+    writer.finish();
+}
+
+// A cache from another font file or built with other settings is not an
+// error, it is rebuilt and overwritten.
+bool SdfFont::read(std::span<const std::byte> data, Uint64 font_hash) {
+    SnapshotReader reader{data};
+
+    Uint32 version = 0;
+    Uint64 hash = 0;
+    float base_size = 0;
+    int oversample = 0;
+    float spread = 0;
+    reader.read(version);
+    reader.read(hash);
+    reader.read(base_size);
+    reader.read(oversample);
+    reader.read(spread);
+    if (version != SDF_CACHE_VERSION || hash != font_hash ||
+        std::memcmp(&base_size, &SDF_BASE_SIZE, sizeof(float)) != 0 ||
+        oversample != SDF_OVERSAMPLE ||
+        std::memcmp(&spread, &SDF_SPREAD, sizeof(float)) != 0) {
+        return false;
+    }
+
+    Uint64 glyph_count = 0;
+    reader.read(this->line_height);
+    reader.read(this->atlas_w);
+    reader.read(this->atlas_h);
+    reader.read(glyph_count);
+    if (glyph_count != SDF_LAST_CHAR - SDF_FIRST_CHAR + 1 ||
+        this->atlas_w <= 0 || this->atlas_h <= 0 ||
+        this->atlas_w > SDF_ATLAS_SIZE || this->atlas_h > SDF_ATLAS_SIZE) {
+        return false;
+    }
+
+    this->glyphs.resize(static_cast<std::size_t>(glyph_count));
+    reader.readArray(this->glyphs.data(), this->glyphs.size());
+    this->distances.resize(static_cast<std::size_t>(this->atlas_w) *
+                           static_cast<std::size_t>(this->atlas_h));
+    reader.readArray(this->distances.data(), this->distances.size());
+    return true;
+}
+
+// Failing to write the cache only costs a rebuild next launch, so it is
+// reported and otherwise ignored.
+void SdfFont::load(const std::string &font_path) {
+    Uint64 font_hash = fontHash(font_path);
+    std::string cache_path = sdfCachePath(font_path);
+    std::vector<std::byte> buffer;
+
+    this->from_cache = false;
+    try {
+        loadSnapshotFile(cache_path.c_str(), buffer);
+        this->from_cache = this->read(buffer, font_hash);
+    } catch (const std::runtime_error &) {
+        this->from_cache = false;
+    }
+    if (this->from_cache) {
+        return;
+    }
+
+    this->generate(font_path);
+    this->write(buffer, font_hash);
+    try {
+        saveSnapshotFile(cache_path.c_str(), buffer);
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void SdfFont::build(SDL_Renderer *renderer, bool keep_surfaces) {
+    std::vector<Uint8> pixels(this->distances.size() * 4);
+    this->textures.clear();
+    this->surfaces.clear();
+
+    for (int i = 0; i < SDF_BUCKETS; i++) {
+        // Screen pixels per base pixel at this bucket, the edge ramp is one
+        // screen pixel wide around the outline.
+        float scale = std::ldexp(1.0f, i + SDF_BUCKET_FIRST);
+        std::array<Uint8, 256> coverage;
+        for (std::size_t value = 0; value < coverage.size(); value++) {
+            float distance = (static_cast<float>(value) - 127.5f) / 127.5f *
+                             SDF_SPREAD * scale;
+            coverage[value] = static_cast<Uint8>(
+                std::clamp(distance + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        for (std::size_t p = 0; p < this->distances.size(); p++) {
+            pixels[p * 4 + 0] = 255;
+            pixels[p * 4 + 1] = 255;
+            pixels[p * 4 + 2] = 255;
+            pixels[p * 4 + 3] = coverage[this->distances[p]];
+        }
+
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                              SDL_TEXTUREACCESS_STATIC, this->atlas_w,
+                              this->atlas_h),
+            SDL_DestroyTexture};
+        if (!texture) {
+            auto error =
+                std::format("Error creating Texture: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        if (!SDL_UpdateTexture(texture.get(), nullptr, pixels.data(),
+                               this->atlas_w * 4)) {
+            auto error =
+                std::format("Error updating Texture: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        SDL_SetTextureScaleMode(texture.get(), SDL_SCALEMODE_LINEAR);
+        this->textures.push_back(std::move(texture));
+
+        if (keep_surfaces) {
+            std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>
+                surface{SDL_CreateSurface(this->atlas_w, this->atlas_h,
+                                          SDL_PIXELFORMAT_RGBA32),
+                        SDL_DestroySurface};
+            if (!surface) {
+                auto error =
+                    std::format("Error creating Surface: {}", SDL_GetError());
+                throw std::runtime_error(error);
+            }
+            std::size_t row = static_cast<std::size_t>(this->atlas_w) * 4;
+            for (int y = 0; y < this->atlas_h; y++) {
+                std::memcpy(static_cast<Uint8 *>(surface->pixels) +
+                                y * surface->pitch,
+                            pixels.data() + static_cast<std::size_t>(y) * row,
+                            row);
+            }
+            this->surfaces.push_back(std::move(surface));
+        }
+    }
+}
+
+std::size_t SdfFont::textureBytes() const {
+    return this->textures.size() * this->distances.size() * 4;
+}
+
+const SdfGlyph &SdfFont::glyph(char ch) const {
+    if (ch < SDF_FIRST_CHAR || ch > SDF_LAST_CHAR) {
+        ch = '?';
+    }
+    return this->glyphs[static_cast<std::size_t>(ch - SDF_FIRST_CHAR)];
+}
+
+int SdfFont::bucket(float scale) {
+    int exponent = static_cast<int>(std::lround(std::log2(scale)));
+    return std::clamp(exponent - SDF_BUCKET_FIRST, 0, SDF_BUCKETS - 1);
+}
+
+SDL_FPoint SdfFont::measure(std::string_view str, float size) const {
+    float width = 0;
+    for (char ch : str) {
+        width += this->glyph(ch).advance;
+    }
+
+    float scale = size / SDF_BASE_SIZE;
+    return {width * scale, this->line_height * scale};
+}
+
+// One quad per visible glyph, all from the same texture, so a whole label
+// merges into one batch with everything else drawn at that bucket.
+void SdfFont::record(CommandBuffer &commands, RenderLayer layer,
+                     std::string_view str, float x, float y, float size,
+                     SDL_Color color) const {
+    const float scale = size / SDF_BASE_SIZE;
+    SDL_Texture *texture = this->textures[static_cast<std::size_t>(
+                                              bucket(scale))]
+                               .get();
+    const SDL_FColor tint = {color.r / 255.0f, color.g / 255.0f,
+                             color.b / 255.0f, color.a / 255.0f};
+    const float inv_w = 1.0f / static_cast<float>(this->atlas_w);
+    const float inv_h = 1.0f / static_cast<float>(this->atlas_h);
+
+    float pen = x;
+    for (char ch : str) {
+        const SdfGlyph &glyph = this->glyph(ch);
+        if (glyph.rect.w > 0) {
+            SDL_FRect dst = {pen + glyph.offset_x * scale,
+                             y + glyph.offset_y * scale, glyph.rect.w * scale,
+                             glyph.rect.h * scale};
+            SDL_FRect uv = {glyph.rect.x * inv_w, glyph.rect.y * inv_h,
+                            glyph.rect.w * inv_w, glyph.rect.h * inv_h};
+            commands.add(layer, texture, uv, dst, tint);
+        }
+        pen += glyph.advance * scale;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include "command_buffer.h"
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr Uint32 SDF_CACHE_VERSION = 1;
+constexpr float SDF_BASE_SIZE = 48;
+constexpr int SDF_OVERSAMPLE = 4;
+constexpr float SDF_SPREAD = 6;
+constexpr int SDF_ATLAS_SIZE = 1024;
+constexpr char SDF_FIRST_CHAR = ' ';
+constexpr char SDF_LAST_CHAR = '~';
+constexpr int SDF_BUCKETS = 5;
+constexpr int SDF_BUCKET_FIRST = -2;
+
+// Where a glyph's distance field sits in the atlas and how to place it, in
+// pixels at SDF_BASE_SIZE. Offsets are from the pen position on the top of
+// the line to the top left of the padded cell.
+struct SdfGlyph {
+        SDL_FRect rect;
+        float offset_x;
+        float offset_y;
+        float advance;
+};
+
+// Printable ASCII from one font as a signed distance field atlas, so text
+// can be drawn at any size without opening the font again. The field is
+// built once from glyphs rasterized at SDF_OVERSAMPLE times the base size
+// and cached next to the font, keyed by a hash of the font file.
+//
+// The SDL renderer has no way to threshold a distance field per pixel, so
+// build() turns the field into one coverage texture per power of two scale
+// from 1/4 to 4 with an edge one screen pixel wide. Text is drawn from the
+// bucket nearest its size and scaled the rest of the way by the GPU. With
+// keep_surfaces the coverage is also kept in RGBA32 surfaces for the
+// software rasterizer.
+class SdfFont {
+    public:
+        SdfFont();
+
+        void load(const std::string &font_path);
+        void build(SDL_Renderer *renderer, bool keep_surfaces = false);
+
+        SDL_FPoint measure(std::string_view str, float size) const;
+        void record(CommandBuffer &commands, RenderLayer layer,
+                    std::string_view str, float x, float y, float size,
+                    SDL_Color color) const;
+
+        bool loaded() const { return !this->glyphs.empty(); }
+        bool cached() const { return this->from_cache; }
+        std::size_t atlasBytes() const { return this->distances.size(); }
+        std::size_t textureBytes() const;
+        std::size_t buckets() const { return this->textures.size(); }
+        SDL_Texture *texture(std::size_t bucket) const {
+            return this->textures[bucket].get();
+        }
+        SDL_Surface *surface(std::size_t bucket) const {
+            return bucket < this->surfaces.size() ? this->surfaces[bucket].get()
+                                                  : nullptr;
+        }
+
+    private:
+        const SdfGlyph &glyph(char ch) const;
+        static int bucket(float scale);
+
+        void generate(const std::string &font_path);
+        void write(std::vector<std::byte> &buffer, Uint64 font_hash) const;
+        bool read(std::span<const std::byte> data, Uint64 font_hash);
+
+        float line_height;
+        int atlas_w;
+        int atlas_h;
+        bool from_cache;
+        std::vector<SdfGlyph> glyphs;
+        std::vector<Uint8> distances;
+        std::vector<std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>>
+            textures;
+        std::vector<std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>>
+            surfaces;
+};
+
+std::string sdfCachePath(const std::string &font_path);
+
+#endif
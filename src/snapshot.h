@@ -0,0 +1,94 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "main.h"
+#include <span>
+#include <type_traits>
+#include <vector>
+
+constexpr Uint32 SNAPSHOT_MAGIC = 0x50414E53; // "SNAP" in little endian
+constexpr Uint32 SNAPSHOT_VERSION = 4;
+constexpr const char *SNAPSHOT_PATH = "quicksave.snap";
+
+// Fixed header in front of every snapshot. The hash covers the payload only,
+// so two worlds in the same state give the same hash whatever file they end
+// up in. Values are stored in native byte order, a snapshot from a machine
+// of the other endianness fails the magic check.
+struct SnapshotHeader {
+        Uint32 magic;
+        Uint32 version;
+        Uint64 size;
+        Uint64 hash;
+};
+
+// Appends plain values to a caller owned buffer. Reusing the same buffer
+// between saves means a quicksave allocates nothing once it has grown to
+// fit, and arrays are copied with one memcpy each.
+class SnapshotWriter {
+    public:
+        explicit SnapshotWriter(std::vector<std::byte> &buffer);
+
+        template <typename T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->writeBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void writeArray(const T *values, std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->writeBytes(values, sizeof(T) * count);
+        }
+
+        // Fills in the header and returns the payload hash.
+        Uint64 finish();
+
+    private:
+        void writeBytes(const void *data, std::size_t size);
+
+        std::vector<std::byte> &buffer;
+};
+
+// Reads values back in the order they were written. The header is checked
+// up front and every read is bounds checked, a bad or truncated snapshot
+// throws instead of loading garbage.
+class SnapshotReader {
+    public:
+        explicit SnapshotReader(std::span<const std::byte> data);
+
+        template <typename T>
+        void read(T &value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->readBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void readArray(T *values, std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->readBytes(values, sizeof(T) * count);
+        }
+
+        // Moves past values without reading them, with the same bounds
+        // check. Used on a copy of the reader to validate a snapshot
+        // before any of it is applied.
+        template <typename T>
+        void skip(std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            this->readBytes(nullptr, sizeof(T) * count);
+        }
+
+        Uint64 hash() const { return this->header.hash; }
+
+    private:
+        void readBytes(void *data, std::size_t size);
+
+        std::span<const std::byte> payload;
+        std::size_t offset;
+        SnapshotHeader header;
+};
+
+Uint64 snapshotHash(std::span<const std::byte> data);
+void saveSnapshotFile(const char *path, const std::vector<std::byte> &buffer);
+void loadSnapshotFile(const char *path, std::vector<std::byte> &buffer);
+
+#endif
@@ -0,0 +1,506 @@
+#include "soft_raster.h"
+#include "blit.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+constexpr int RASTER_SUBPIXEL_BITS = 8;
+constexpr Sint64 RASTER_SUBPIXEL = 1 << RASTER_SUBPIXEL_BITS;
+constexpr Sint64 RASTER_HALF_PIXEL = RASTER_SUBPIXEL / 2;
+
+enum RasterAttr { ATTR_U, ATTR_V, ATTR_R, ATTR_G, ATTR_B, ATTR_A };
+
+SoftRasterizer::SoftRasterizer()
+    : width{0},
+      height{0},
+      tiles_x{0},
+      tiles_y{0},
+      clear_pixel{0},
+      target{nullptr, SDL_DestroySurface},
+      output{},
+      texture_surfaces{},
+      batches{},
+      batch_surfaces{},
+      refs{},
+      triangles{},
+      bins{},
+      next_tile{0},
+      raster_stats{0, 0, 0},
+      sync{},
+      stopping{false},
+      workers{} {}
+
+SoftRasterizer::~SoftRasterizer() { this->reset(); }
+
+void SoftRasterizer::setup(int target_width, int target_height,
+                           std::size_t threads) {
+    this->reset();
+
+    this->target.reset(SDL_CreateSurface(target_width, target_height,
+                                         SDL_PIXELFORMAT_RGBA32));
+    if (!this->target) {
+        auto error = std::format("Error creating raster Surface: {}",
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->width = target_width;
+    this->height = target_height;
+    this->tiles_x = (target_width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    this->tiles_y = (target_height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+
+    threads = std::max<std::size_t>(threads, 1);
+    this->bins.assign(threads,
+                      std::vector<std::vector<Uint32>>(static_cast<std::size_t>(
+                          this->tiles_x * this->tiles_y)));
+    this->stopping = false;
+    this->sync = std::make_unique<std::barrier<>>(
+        static_cast<std::ptrdiff_t>(threads));
+    for (std::size_t thread = 1; thread < threads; thread++) {
+        this->workers.emplace_back([this, thread] { this->run(thread); });
+    }
+}
+
+// Workers are parked on the frame start barrier, arriving there once more
+// with stopping set lets them return.
+void SoftRasterizer::reset() {
+    if (!this->workers.empty()) {
+        this->stopping = true;
+        this->sync->arrive_and_wait();
+        this->workers.clear();
+    }
+    this->sync.reset();
+    this->bins.clear();
+    this->texture_surfaces.clear();
+    this->output.reset();
+    this->target.reset();
+}
+
+void SoftRasterizer::addTexture(SDL_Texture *sdl_texture,
+                                SDL_Surface *surface) {
+    if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+        auto error = std::format("Error adding raster Texture: format {} is "
+                                 "not RGBA32",
+                                 static_cast<Uint32>(surface->format));
+        throw std::runtime_error(error);
+    }
+    this->texture_surfaces.insert_or_assign(sdl_texture, surface);
+}
+
+void SoftRasterizer::run(std::size_t thread) {
+    traceThreadName(std::format("raster {}", thread));
+    while (true) {
+        this->sync->arrive_and_wait();
+        if (this->stopping) {
+            return;
+        }
+        this->setupTriangles(thread);
+        this->sync->arrive_and_wait();
+        this->rasterTiles();
+        this->sync->arrive_and_wait();
+    }
+}
+
+void SoftRasterizer::draw(const CommandBuffer &commands, SDL_Color clear) {
+    this->clear_pixel = static_cast<Uint32>(clear.a) << 24 |
+                        static_cast<Uint32>(clear.b) << 16 |
+                        static_cast<Uint32>(clear.g) << 8 | clear.r;
+
+    this->batches.clear();
+    this->batch_surfaces.clear();
+    this->refs.clear();
+    for (std::size_t i = 0; i < commands.batches(); i++) {
+        CommandBatch batch = commands.batch(i);
+        SDL_Surface *surface = nullptr;
+        if (batch.texture) {
+            auto found = this->texture_surfaces.find(batch.texture);
+            if (found == this->texture_surfaces.end()) {
+                continue;
+            }
+            surface = found->second;
+        }
+
+        auto index = static_cast<Uint32>(this->batches.size());
+        this->batches.push_back(batch);
+        this->batch_surfaces.push_back(surface);
+        for (int first = 0; first + 2 < batch.num_indices; first += 3) {
+            this->refs.push_back({index, static_cast<Uint32>(first)});
+        }
+    }
+    this->triangles.resize(this->refs.size());
+    this->next_tile = 0;
+
+    // The calling thread takes the first slice and its share of tiles.
+    this->sync->arrive_and_wait();
+    this->setupTriangles(0);
+    this->sync->arrive_and_wait();
+    this->rasterTiles();
+    this->sync->arrive_and_wait();
+
+    std::size_t binned = 0;
+    for (const auto &thread_bins : this->bins) {
+        for (const auto &bin : thread_bins) {
+            binned += bin.size();
+        }
+    }
+    this->raster_stats = {this->refs.size(), binned,
+                          static_cast<std::size_t>(this->tiles_x *
+                                                   this->tiles_y)};
+}
+
+void SoftRasterizer::present(SDL_Renderer *renderer) {
+    TraceScope scope{"rasterPresent"};
+    if (this->output.renderer() != renderer) {
+        this->output.setup(renderer, this->width, this->height);
+        this->output.setBlendMode(SDL_BLENDMODE_NONE);
+    }
+
+    StreamingLock lock = this->output.lock();
+    const auto row_bytes = static_cast<std::size_t>(this->width) * 4;
+    for (int y = 0; y < this->height; y++) {
+        std::memcpy(lock.row(y),
+                    static_cast<const Uint8 *>(this->target->pixels) +
+                        y * this->target->pitch,
+                    row_bytes);
+    }
+    this->output.unlock();
+
+    SDL_RenderTexture(renderer, this->output.texture(), nullptr, nullptr);
+}
+
+template <typename T>
+static const T &strided(const void *base, int index, int stride) {
+    return *reinterpret_cast<const T *>(static_cast<const Uint8 *>(base) +
+                                        static_cast<std::ptrdiff_t>(index) *
+                                            stride);
+}
+
+static Uint32 packAttributes(const std::array<float, 6> &attr) {
+    auto channel = [](float value) {
+        return static_cast<Uint32>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+    };
+    return channel(attr[ATTR_A]) << 24 | channel(attr[ATTR_B]) << 16 |
+           channel(attr[ATTR_G]) << 8 | channel(attr[ATTR_R]);
+}
+
+bool SoftRasterizer::setupTriangle(const TriangleRef &ref,
+                                   Triangle &triangle) const {
+    const CommandBatch &batch = this->batches[ref.batch];
+    const SDL_Surface *surface = this->batch_surfaces[ref.batch];
+
+    std::array<Sint64, 3> fx;
+    std::array<Sint64, 3> fy;
+    std::array<std::array<float, 6>, 3> attrs;
+    float min_xf = std::numeric_limits<float>::max();
+    float min_yf = std::numeric_limits<float>::max();
+    float max_xf = std::numeric_limits<float>::lowest();
+    float max_yf = std::numeric_limits<float>::lowest();
+
+    for (std::size_t k = 0; k < 3; k++) {
+        int index = batch.indices[ref.first + k];
+        const float *xy = &strided<float>(batch.xy, index, batch.xy_stride);
+        const SDL_FColor &color =
+            strided<SDL_FColor>(batch.colors, index, batch.color_stride);
+
+        fx[k] = std::llround(xy[0] * RASTER_SUBPIXEL);
+        fy[k] = std::llround(xy[1] * RASTER_SUBPIXEL);
+        min_xf = std::min(min_xf, xy[0]);
+        min_yf = std::min(min_yf, xy[1]);
+        max_xf = std::max(max_xf, xy[0]);
+        max_yf = std::max(max_yf, xy[1]);
+
+        attrs[k] = {0, 0, color.r * 255.0f, color.g * 255.0f,
+                    color.b * 255.0f, color.a * 255.0f};
+        if (batch.uv && surface) {
+            const float *uv = &strided<float>(batch.uv, index, batch.uv_stride);
+            attrs[k][ATTR_U] = uv[0] * static_cast<float>(surface->w);
+            attrs[k][ATTR_V] = uv[1] * static_cast<float>(surface->h);
+        }
+    }
+
+    Sint64 area = (fx[1] - fx[0]) * (fy[2] - fy[0]) -
+                  (fy[1] - fy[0]) * (fx[2] - fx[0]);
+    if (area == 0) {
+        return false;
+    }
+    if (area < 0) {
+        std::swap(fx[1], fx[2]);
+        std::swap(fy[1], fy[2]);
+        std::swap(attrs[1], attrs[2]);
+        area = -area;
+    }
+
+    triangle.min_x = std::max(static_cast<int>(std::floor(min_xf)), 0);
+    triangle.min_y = std::max(static_cast<int>(std::floor(min_yf)), 0);
+    triangle.max_x =
+        std::min(static_cast<int>(std::ceil(max_xf)), this->width - 1);
+    triangle.max_y =
+        std::min(static_cast<int>(std::ceil(max_yf)), this->height - 1);
+    if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+        return false;
+    }
+
+    const Sint64 origin_x =
+        triangle.min_x * RASTER_SUBPIXEL + RASTER_HALF_PIXEL;
+    const Sint64 origin_y =
+        triangle.min_y * RASTER_SUBPIXEL + RASTER_HALF_PIXEL;
+    const double inv_area = 1.0 / static_cast<double>(area);
+    std::array<double, 6> attr_origin{};
+    std::array<double, 6> attr_x{};
+    std::array<double, 6> attr_y{};
+
+    // Edge k is opposite vertex k and is the area weight of that vertex.
+    for (std::size_t k = 0; k < 3; k++) {
+        std::size_t a = (k + 1) % 3;
+        std::size_t b = (k + 2) % 3;
+        Sint64 step_x = -(fy[b] - fy[a]);
+        Sint64 step_y = fx[b] - fx[a];
+        Sint64 constant = -(step_x * fx[a] + step_y * fy[a]);
+        Sint64 at_origin = step_x * origin_x + step_y * origin_y + constant;
+
+        double weight = static_cast<double>(at_origin) * inv_area;
+        double weight_x =
+            static_cast<double>(step_x * RASTER_SUBPIXEL) * inv_area;
+        double weight_y =
+            static_cast<double>(step_y * RASTER_SUBPIXEL) * inv_area;
+        for (std::size_t i = 0; i < attr_origin.size(); i++) {
+            attr_origin[i] += attrs[k][i] * weight;
+            attr_x[i] += attrs[k][i] * weight_x;
+            attr_y[i] += attrs[k][i] * weight_y;
+        }
+
+        // Pixels exactly on an edge shared by two triangles belong to only
+        // one of them, the edge direction decides which.
+        bool owns_edge = step_x > 0 || (step_x == 0 && step_y > 0);
+        triangle.edge_x[k] = step_x * RASTER_SUBPIXEL;
+        triangle.edge_y[k] = step_y * RASTER_SUBPIXEL;
+        triangle.edge_origin[k] = at_origin - (owns_edge ? 0 : 1);
+    }
+
+    for (std::size_t i = 0; i < attr_origin.size(); i++) {
+        triangle.attr_origin[i] = static_cast<float>(attr_origin[i]);
+        triangle.attr_x[i] = static_cast<float>(attr_x[i]);
+        triangle.attr_y[i] = static_cast<float>(attr_y[i]);
+    }
+    triangle.color = packAttributes(attrs[0]);
+    triangle.flat = triangle.color == packAttributes(attrs[1]) &&
+                    triangle.color == packAttributes(attrs[2]);
+    triangle.texture = surface;
+    triangle.blend = batch.blend;
+    return true;
+}
+
+void SoftRasterizer::setupTriangles(std::size_t thread) {
+    TraceScope scope{"setupTriangles"};
+    const std::size_t count = this->refs.size();
+    const std::size_t threads = this->bins.size();
+    const std::size_t first = count * thread / threads;
+    const std::size_t last = count * (thread + 1) / threads;
+
+    std::vector<std::vector<Uint32>> &thread_bins = this->bins[thread];
+    for (std::vector<Uint32> &bin : thread_bins) {
+        bin.clear();
+    }
+
+    for (std::size_t i = first; i < last; i++) {
+        Triangle &triangle = this->triangles[i];
+        if (!this->setupTriangle(this->refs[i], triangle)) {
+            continue;
+        }
+
+        int tile_x0 = triangle.min_x / RASTER_TILE_SIZE;
+        int tile_y0 = triangle.min_y / RASTER_TILE_SIZE;
+        int tile_x1 = triangle.max_x / RASTER_TILE_SIZE;
+        int tile_y1 = triangle.max_y / RASTER_TILE_SIZE;
+        for (int ty = tile_y0; ty <= tile_y1; ty++) {
+            for (int tx = tile_x0; tx <= tile_x1; tx++) {
+                thread_bins[static_cast<std::size_t>(ty * this->tiles_x + tx)]
+                    .push_back(static_cast<Uint32>(i));
+            }
+        }
+    }
+}
+
+void SoftRasterizer::rasterTiles() {
+    TraceScope scope{"rasterTiles"};
+    const int tiles = this->tiles_x * this->tiles_y;
+    for (int tile = this->next_tile++; tile < tiles;
+         tile = this->next_tile++) {
+        this->rasterTile(tile);
+    }
+}
+
+enum class RasterBlend : Uint8 { None, Add, Blend };
+
+// x * y / 255 rounded to nearest, for channels in 0..255.
+static Uint32 mulChannel(Uint32 x, Uint32 y) {
+    Uint32 product = x * y + 0x80;
+    return (product + (product >> 8)) >> 8;
+}
+
+static Uint32 modulatePixel(Uint32 texel, Uint32 color) {
+    Uint32 pixel = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        pixel |= mulChannel(texel >> shift & 0xFF, color >> shift & 0xFF)
+                 << shift;
+    }
+    return pixel;
+}
+
+// SDL_BLENDMODE_ADD keeps the destination alpha and saturates each colour.
+static Uint32 addPixel(Uint32 src, Uint32 dst) {
+    Uint32 alpha = src >> 24;
+    Uint32 pixel = dst & 0xFF000000;
+    for (int shift = 0; shift < 24; shift += 8) {
+        Uint32 sum = (dst >> shift & 0xFF) + mulChannel(src >> shift & 0xFF,
+                                                        alpha);
+        pixel |= std::min<Uint32>(sum, 0xFF) << shift;
+    }
+    return pixel;
+}
+
+// One covered run of a row. Every triangle picks its instance once, so the
+// pixel loop carries no branches on blend mode, texturing or whether the
+// vertex colours differ. Pixels are blended in integers like the blit
+// kernels, only the interpolated attributes are floats.
+template <RasterBlend Blend, bool Textured, bool Flat>
+static void rasterSpan(Uint32 *row, int first, int last,
+                       std::array<float, 6> attr,
+                       const std::array<float, 6> &step, Uint32 color,
+                       const SDL_Surface *tex) {
+    const bool white = color == 0xFFFFFFFF;
+    for (int x = first; x <= last; x++) {
+        if constexpr (!Flat) {
+            color = packAttributes(attr);
+        }
+
+        Uint32 src = color;
+        if constexpr (Textured) {
+            int u = std::clamp(static_cast<int>(attr[ATTR_U]), 0, tex->w - 1);
+            int v = std::clamp(static_cast<int>(attr[ATTR_V]), 0, tex->h - 1);
+            src = reinterpret_cast<const Uint32 *>(
+                static_cast<const Uint8 *>(tex->pixels) + v * tex->pitch)[u];
+            if (!Flat || !white) {
+                src = modulatePixel(src, color);
+            }
+            attr[ATTR_U] += step[ATTR_U];
+            attr[ATTR_V] += step[ATTR_V];
+        }
+
+        Uint32 &dst = row[x];
+        if constexpr (Blend == RasterBlend::None) {
+            dst = src;
+        } else if constexpr (Blend == RasterBlend::Add) {
+            dst = addPixel(src, dst);
+        } else {
+            dst = blendPixel<BlitBlend::Blend>(src, dst);
+        }
+
+        if constexpr (!Flat) {
+            for (std::size_t i = ATTR_R; i <= ATTR_A; i++) {
+                attr[i] += step[i];
+            }
+        }
+    }
+}
+
+using RasterSpan = void (*)(Uint32 *, int, int, std::array<float, 6>,
+                            const std::array<float, 6> &, Uint32,
+                            const SDL_Surface *);
+
+template <RasterBlend Blend>
+static RasterSpan rasterSpanFor(bool textured, bool flat) {
+    if (textured) {
+        return flat ? rasterSpan<Blend, true, true>
+                    : rasterSpan<Blend, true, false>;
+    }
+    return flat ? rasterSpan<Blend, false, true>
+                : rasterSpan<Blend, false, false>;
+}
+
+static RasterSpan rasterSpanFor(SDL_BlendMode blend, bool textured,
+                                bool flat) {
+    switch (blend) {
+    case SDL_BLENDMODE_NONE:
+        return rasterSpanFor<RasterBlend::None>(textured, flat);
+    case SDL_BLENDMODE_ADD:
+        return rasterSpanFor<RasterBlend::Add>(textured, flat);
+    default:
+        return rasterSpanFor<RasterBlend::Blend>(textured, flat);
+    }
+}
+
+// Narrows [first, last] to the pixels where an edge function starting at
+// value and changing by step per pixel is non negative.
+static void clipSpan(Sint64 value, Sint64 step, int &first, int &last) {
+    if (step > 0) {
+        if (value < 0) {
+            Sint64 skip = (-value + step - 1) / step;
+            first = static_cast<int>(
+                std::min<Sint64>(first + skip, static_cast<Sint64>(last) + 1));
+        }
+    } else if (step < 0) {
+        if (value < 0) {
+            last = first - 1;
+        } else {
+            last = static_cast<int>(
+                std::min<Sint64>(last, first + value / -step));
+        }
+    } else if (value < 0) {
+        last = first - 1;
+    }
+}
+
+void SoftRasterizer::rasterTile(int tile) {
+    const int x0 = tile % this->tiles_x * RASTER_TILE_SIZE;
+    const int y0 = tile / this->tiles_x * RASTER_TILE_SIZE;
+    const int x1 = std::min(x0 + RASTER_TILE_SIZE, this->width) - 1;
+    const int y1 = std::min(y0 + RASTER_TILE_SIZE, this->height) - 1;
+    const auto tile_index = static_cast<std::size_t>(tile);
+    auto *pixels = static_cast<Uint8 *>(this->target->pixels);
+    const int pitch = this->target->pitch;
+
+    for (int y = y0; y <= y1; y++) {
+        Uint32 *row = reinterpret_cast<Uint32 *>(pixels + y * pitch);
+        std::fill(row + x0, row + x1 + 1, this->clear_pixel);
+    }
+
+    for (const auto &thread_bins : this->bins) {
+        for (Uint32 index : thread_bins[tile_index]) {
+            const Triangle &tri = this->triangles[index];
+            const int left = std::max(tri.min_x, x0);
+            const int right = std::min(tri.max_x, x1);
+            const int top = std::max(tri.min_y, y0);
+            const int bottom = std::min(tri.max_y, y1);
+            const RasterSpan span =
+                rasterSpanFor(tri.blend, tri.texture != nullptr, tri.flat);
+
+            for (int y = top; y <= bottom; y++) {
+                const int dy = y - tri.min_y;
+                int first = left;
+                int last = right;
+                for (std::size_t k = 0; k < 3 && first <= last; k++) {
+                    Sint64 edge = tri.edge_origin[k] +
+                                  tri.edge_x[k] * (first - tri.min_x) +
+                                  tri.edge_y[k] * dy;
+                    clipSpan(edge, tri.edge_x[k], first, last);
+                }
+                if (first > last) {
+                    continue;
+                }
+
+                const auto fx = static_cast<float>(first - tri.min_x);
+                const auto fy = static_cast<float>(dy);
+                std::array<float, 6> attr;
+                for (std::size_t i = 0; i < attr.size(); i++) {
+                    attr[i] = tri.attr_origin[i] + tri.attr_x[i] * fx +
+                              tri.attr_y[i] * fy;
+                }
+                span(reinterpret_cast<Uint32 *>(pixels + y * pitch), first,
+                     last, attr, tri.attr_x, tri.color, tri.texture);
+            }
+        }
+    }
+}
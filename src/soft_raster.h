@@ -0,0 +1,108 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include "command_buffer.h"
+#include "streaming_texture.h"
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <unordered_map>
+
+constexpr int RASTER_TILE_SIZE = 64;
+
+struct RasterStats {
+        std::size_t triangles;
+        std::size_t binned;
+        std::size_t tiles;
+};
+
+// Draws a sorted CommandBuffer on the CPU for machines where SDL would
+// otherwise fall back to its single threaded software renderer. Triangles
+// are set up and binned into RASTER_TILE_SIZE screen tiles by every thread
+// for its own slice of the draw list, then whole tiles are rasterized in
+// parallel. A tile walks the slices in order, so draw order and blending
+// match submit() without any locking on the target.
+//
+// The target is an RGBA32 surface copied into a double buffered streaming
+// texture to be presented.
+// Textured geometry samples the surface registered for its texture with
+// addTexture(), nearest texel, modulated by the vertex colour. Blend modes
+// other than none and add are drawn as SDL_BLENDMODE_BLEND.
+class SoftRasterizer {
+    public:
+        SoftRasterizer();
+        ~SoftRasterizer();
+
+        SoftRasterizer(const SoftRasterizer &) = delete;
+        SoftRasterizer &operator=(const SoftRasterizer &) = delete;
+
+        void setup(int width, int height, std::size_t threads);
+        void reset();
+
+        void addTexture(SDL_Texture *texture, SDL_Surface *surface);
+        void draw(const CommandBuffer &commands, SDL_Color clear_color);
+        void present(SDL_Renderer *renderer);
+
+        bool active() const { return static_cast<bool>(this->target); }
+        SDL_Surface *surface() const { return this->target.get(); }
+        std::size_t threads() const { return this->workers.size() + 1; }
+        RasterStats stats() const { return this->raster_stats; }
+
+    private:
+        // Edges are 24.8 fixed point functions evaluated at pixel centres,
+        // inside when all three are non negative. Attributes are planes in
+        // screen pixels from the centre of the top left bounding box pixel,
+        // texture coordinates already scaled to texels.
+        struct Triangle {
+                int min_x;
+                int min_y;
+                int max_x;
+                int max_y;
+                std::array<Sint64, 3> edge_x;
+                std::array<Sint64, 3> edge_y;
+                std::array<Sint64, 3> edge_origin;
+                std::array<float, 6> attr_origin;
+                std::array<float, 6> attr_x;
+                std::array<float, 6> attr_y;
+                Uint32 color;
+                bool flat;
+                const SDL_Surface *texture;
+                SDL_BlendMode blend;
+        };
+
+        struct TriangleRef {
+                Uint32 batch;
+                Uint32 first;
+        };
+
+        void run(std::size_t thread);
+        void setupTriangles(std::size_t thread);
+        void rasterTiles();
+        void rasterTile(int tile);
+        bool setupTriangle(const TriangleRef &ref, Triangle &triangle) const;
+
+        int width;
+        int height;
+        int tiles_x;
+        int tiles_y;
+        Uint32 clear_pixel;
+        std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> target;
+        StreamingTexture output;
+        std::unordered_map<SDL_Texture *, SDL_Surface *> texture_surfaces;
+
+        std::vector<CommandBatch> batches;
+        std::vector<SDL_Surface *> batch_surfaces;
+        std::vector<TriangleRef> refs;
+        std::vector<Triangle> triangles;
+        // Per thread, per tile, indices into triangles in draw order.
+        std::vector<std::vector<std::vector<Uint32>>> bins;
+        std::atomic<int> next_tile;
+        RasterStats raster_stats;
+
+        std::unique_ptr<std::barrier<>> sync;
+        std::atomic<bool> stopping;
+        std::vector<std::jthread> workers;
+};
+
+#endif
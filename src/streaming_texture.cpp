@@ -0,0 +1,130 @@
+#include "streaming_texture.h"
+
+StreamingTexture::StreamingTexture()
+    : textures{},
+      stale{},
+      texture_renderer{nullptr},
+      width{0},
+      height{0},
+      front{0},
+      locked{false},
+      locked_rect{},
+      changed_rect{},
+      uploaded{0} {}
+
+void StreamingTexture::setup(SDL_Renderer *renderer, int texture_width,
+                             int texture_height, std::size_t buffers) {
+    this->reset();
+
+    for (std::size_t i = 0; i < std::max<std::size_t>(buffers, 1); i++) {
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                              SDL_TEXTUREACCESS_STREAMING, texture_width,
+                              texture_height),
+            SDL_DestroyTexture};
+        if (!texture) {
+            auto error = std::format("Error creating streaming Texture: {}",
+                                     SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        this->textures.push_back(std::move(texture));
+    }
+
+    this->stale.assign(this->textures.size(),
+                       {0, 0, texture_width, texture_height});
+    this->texture_renderer = renderer;
+    this->width = texture_width;
+    this->height = texture_height;
+    this->front = this->textures.size() - 1;
+}
+
+void StreamingTexture::reset() {
+    if (this->locked) {
+        this->unlock();
+    }
+    this->textures.clear();
+    this->stale.clear();
+    this->texture_renderer = nullptr;
+    this->width = 0;
+    this->height = 0;
+    this->front = 0;
+}
+
+void StreamingTexture::setBlendMode(SDL_BlendMode blend) {
+    for (const auto &texture : this->textures) {
+        SDL_SetTextureBlendMode(texture.get(), blend);
+    }
+}
+
+StreamingLock StreamingTexture::lock(const SDL_Rect *rect) {
+    if (this->locked) {
+        throw std::runtime_error("Error locking streaming Texture: already "
+                                 "locked");
+    }
+
+    const SDL_Rect bounds{0, 0, this->width, this->height};
+    SDL_Rect area = bounds;
+    if (rect && !SDL_GetRectIntersection(rect, &bounds, &area)) {
+        area = {0, 0, 0, 0};
+    }
+
+    // Only the asked for part is new, the rest is what the other textures
+    // already show.
+    this->changed_rect = area;
+    std::size_t back = (this->front + 1) % this->textures.size();
+    const SDL_Rect &missed = this->stale[back];
+    if (!SDL_RectEmpty(&missed)) {
+        if (SDL_RectEmpty(&area)) {
+            area = missed;
+        } else {
+            SDL_GetRectUnion(&area, &missed, &area);
+        }
+    }
+
+    StreamingLock lock{nullptr, 0, area};
+    if (!SDL_RectEmpty(&area) &&
+        !SDL_LockTexture(this->textures[back].get(), &area, &lock.pixels,
+                         &lock.pitch)) {
+        auto error = std::format("Error locking streaming Texture: {}",
+                                 SDL_GetError());
+        throw std::runtime_error(error);
+    }
+
+    this->locked = true;
+    this->locked_rect = area;
+    return lock;
+}
+
+// The written texture becomes the one drawn, every other texture now lacks
+// what was just written.
+void StreamingTexture::unlock() {
+    if (!this->locked) {
+        return;
+    }
+    std::size_t back = (this->front + 1) % this->textures.size();
+    const SDL_Rect &area = this->locked_rect;
+    const SDL_Rect &changed = this->changed_rect;
+    if (!SDL_RectEmpty(&area)) {
+        SDL_UnlockTexture(this->textures[back].get());
+        this->uploaded += static_cast<Uint64>(area.w) *
+                          static_cast<Uint64>(area.h) * 4;
+    }
+    for (std::size_t i = 0; i < this->stale.size(); i++) {
+        if (i == back || SDL_RectEmpty(&changed)) {
+            continue;
+        }
+        if (SDL_RectEmpty(&this->stale[i])) {
+            this->stale[i] = changed;
+        } else {
+            SDL_GetRectUnion(&this->stale[i], &changed, &this->stale[i]);
+        }
+    }
+    this->stale[back] = {0, 0, 0, 0};
+    this->front = back;
+    this->locked = false;
+}
+
+SDL_Texture *StreamingTexture::texture() const {
+    return this->textures.empty() ? nullptr
+                                  : this->textures[this->front].get();
+}
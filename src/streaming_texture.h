@@ -0,0 +1,66 @@
+#ifndef STREAMING_TEXTURE_H
+#define STREAMING_TEXTURE_H
+
+#include "main.h"
+#include <vector>
+
+constexpr std::size_t STREAMING_BUFFERS = 2;
+
+// The locked part of a streaming texture. pixels points at the top left of
+// rect and rows are pitch bytes apart. The memory is write only and starts
+// out undefined, every pixel of rect has to be written before unlock().
+struct StreamingLock {
+        Uint32 *row(int y) const {
+            return reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(pixels) +
+                                              y * pitch);
+        }
+
+        void *pixels;
+        int pitch;
+        SDL_Rect rect;
+};
+
+// RGBA32 textures that are rewritten on the CPU every frame. lock() hands
+// out the driver's upload buffer so content is generated straight into it,
+// without a surface to copy from. Updates rotate through several textures,
+// the renderer keeps drawing the last unlocked one while the next is
+// written, so a lock never waits on the GPU still reading it.
+//
+// A rect updates only part of the image. Each texture misses the updates
+// that went into the others since it was last locked, so the locked rect
+// is grown by those and can be larger than asked for. The first lock of
+// every texture covers all of it.
+class StreamingTexture {
+    public:
+        StreamingTexture();
+
+        void setup(SDL_Renderer *renderer, int width, int height,
+                   std::size_t buffers = STREAMING_BUFFERS);
+        void reset();
+        void setBlendMode(SDL_BlendMode blend);
+
+        StreamingLock lock(const SDL_Rect *rect = nullptr);
+        void unlock();
+
+        SDL_Texture *texture() const;
+        SDL_Renderer *renderer() const { return this->texture_renderer; }
+        std::size_t buffers() const { return this->textures.size(); }
+        Uint64 uploadedBytes() const { return this->uploaded; }
+
+    private:
+        std::vector<std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>>
+            textures;
+        // Per texture, the area other textures were updated in since it was
+        // last locked. Empty when the texture is current.
+        std::vector<SDL_Rect> stale;
+        SDL_Renderer *texture_renderer;
+        int width;
+        int height;
+        std::size_t front;
+        bool locked;
+        SDL_Rect locked_rect;
+        SDL_Rect changed_rect;
+        Uint64 uploaded;
+};
+
+#endif
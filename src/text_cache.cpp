@@ -0,0 +1,82 @@
+#include "text_cache.h"
+#include <algorithm>
+#include <iterator>
+
+TextCache::TextCache(std::size_t capacity)
+    : max_entries{std::max<std::size_t>(capacity, 1)},
+      font{nullptr},
+      engine{nullptr, TTF_DestroyRendererTextEngine},
+      entries{},
+      lookup{},
+      cache_stats{0, 0, 0} {
+    this->lookup.reserve(this->max_entries);
+}
+
+TextCache::~TextCache() { this->reset(); }
+
+void TextCache::setup(SDL_Renderer *renderer, TTF_Font *text_font) {
+    this->reset();
+
+    this->engine.reset(TTF_CreateRendererTextEngine(renderer));
+    if (!this->engine) {
+        auto error =
+            std::format("Error creating Text Engine: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    this->font = text_font;
+}
+
+// Texts have to go before the engine that owns their glyph textures, and
+// the engine before the renderer.
+void TextCache::reset() {
+    this->lookup.clear();
+    for (Entry &entry : this->entries) {
+        TTF_DestroyText(entry.text);
+    }
+    this->entries.clear();
+    this->engine.reset();
+}
+
+TTF_Text *TextCache::get(std::string_view str) {
+    auto found = this->lookup.find(str);
+    if (found != this->lookup.end()) {
+        this->cache_stats.hits++;
+        this->entries.splice(this->entries.begin(), this->entries,
+                             found->second);
+        return found->second->text;
+    }
+    this->cache_stats.misses++;
+
+    if (this->entries.size() < this->max_entries) {
+        TTF_Text *text = TTF_CreateText(this->engine.get(), this->font,
+                                        str.data(), str.size());
+        if (!text) {
+            auto error = std::format("Error creating Text: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        this->entries.push_front({std::string{str}, text});
+    } else {
+        auto oldest = std::prev(this->entries.end());
+        this->lookup.erase(oldest->key);
+        this->cache_stats.evictions++;
+
+        if (!TTF_SetTextString(oldest->text, str.data(), str.size())) {
+            TTF_DestroyText(oldest->text);
+            this->entries.erase(oldest);
+            auto error = std::format("Error setting Text: {}", SDL_GetError());
+            throw std::runtime_error(error);
+        }
+        oldest->key.assign(str);
+        this->entries.splice(this->entries.begin(), this->entries, oldest);
+    }
+
+    this->lookup.emplace(this->entries.front().key, this->entries.begin());
+    return this->entries.front().text;
+}
+
+void TextCache::draw(std::string_view str, float x, float y,
+                     SDL_Color color) {
+    TTF_Text *text = this->get(str);
+    TTF_SetTextColor(text, color.r, color.g, color.b, color.a);
+    TTF_DrawRendererText(text, x, y);
+}
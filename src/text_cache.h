@@ -0,0 +1,60 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "main.h"
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+constexpr std::size_t TEXT_CACHE_CAPACITY = 256;
+
+struct TextCacheStats {
+        Uint64 hits;
+        Uint64 misses;
+        Uint64 evictions;
+};
+
+// Keeps shaped TTF_Text objects for recently drawn strings, so a label that
+// shows the same string as last frame is drawn from its existing glyph
+// layout and atlas entries. A new string reshapes the least recently used
+// entry in place with TTF_SetTextString once the cache is full, instead of
+// creating another object. Not thread safe, use it on the render thread.
+class TextCache {
+    public:
+        explicit TextCache(std::size_t capacity = TEXT_CACHE_CAPACITY);
+        ~TextCache();
+
+        TextCache(const TextCache &) = delete;
+        TextCache &operator=(const TextCache &) = delete;
+
+        void setup(SDL_Renderer *renderer, TTF_Font *text_font);
+        void reset();
+
+        TTF_Text *get(std::string_view str);
+        void draw(std::string_view str, float x, float y, SDL_Color color);
+
+        std::size_t size() const { return this->entries.size(); }
+        std::size_t capacity() const { return this->max_entries; }
+        TextCacheStats stats() const { return this->cache_stats; }
+
+    private:
+        struct Entry {
+                std::string key;
+                TTF_Text *text;
+        };
+
+        std::size_t max_entries;
+        TTF_Font *font;
+        std::unique_ptr<TTF_TextEngine,
+                        decltype(&TTF_DestroyRendererTextEngine)>
+            engine;
+        // Most recently used first. Map keys view the strings owned by the
+        // list nodes, which never move.
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator>
+            lookup;
+        TextCacheStats cache_stats;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "tilemap.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr int CHUNK_QUADS = CHUNK_TILES * CHUNK_TILES;
+
+Tilemap::Tilemap(const TextureAtlas &texture_atlas,
+                 const AtlasRegion &tileset_region, int columns, int rows)
+    : atlas{texture_atlas},
+      tileset{tileset_region},
+      tileset_columns{std::max(1, static_cast<int>(tileset_region.rect.w) /
+                                      TILE_SIZE)},
+      map_columns{columns},
+      map_rows{rows},
+      chunk_columns{(columns + CHUNK_TILES - 1) / CHUNK_TILES},
+      chunk_rows{(rows + CHUNK_TILES - 1) / CHUNK_TILES},
+      chunks(static_cast<std::size_t>(this->chunk_columns * this->chunk_rows)),
+      colors(CHUNK_QUADS * 4, SDL_FColor{1, 1, 1, 1}),
+      indices(CHUNK_QUADS * 6) {
+    for (Chunk &chunk : this->chunks) {
+        chunk.tiles.assign(CHUNK_QUADS, TILE_EMPTY);
+        chunk.dirty = true;
+    }
+
+    for (int i = 0; i < CHUNK_QUADS; i++) {
+        int v = i * 4;
+        int *quad = &this->indices[static_cast<std::size_t>(i * 6)];
+        quad[0] = v;
+        quad[1] = v + 1;
+        quad[2] = v + 2;
+        quad[3] = v + 2;
+        quad[4] = v + 3;
+        quad[5] = v;
+    }
+}
+
+float Tilemap::width() const {
+    return static_cast<float>(this->map_columns * TILE_SIZE);
+}
+
+float Tilemap::height() const {
+    return static_cast<float>(this->map_rows * TILE_SIZE);
+}
+
+Tilemap::Chunk &Tilemap::chunkAt(int x, int y) {
+    int index = (y / CHUNK_TILES) * this->chunk_columns + x / CHUNK_TILES;
+    return this->chunks[static_cast<std::size_t>(index)];
+}
+
+const Tilemap::Chunk &Tilemap::chunkAt(int x, int y) const {
+    int index = (y / CHUNK_TILES) * this->chunk_columns + x / CHUNK_TILES;
+    return this->chunks[static_cast<std::size_t>(index)];
+}
+
+void Tilemap::setTile(int x, int y, Uint16 tile) {
+    if (x < 0 || y < 0 || x >= this->map_columns || y >= this->map_rows) {
+        return;
+    }
+
+    Chunk &chunk = this->chunkAt(x, y);
+    Uint16 &slot = chunk.tiles[static_cast<std::size_t>(
+        (y % CHUNK_TILES) * CHUNK_TILES + x % CHUNK_TILES)];
+    if (slot != tile) {
+        slot = tile;
+        chunk.dirty = true;
+    }
+}
+
+Uint16 Tilemap::tile(int x, int y) const {
+    if (x < 0 || y < 0 || x >= this->map_columns || y >= this->map_rows) {
+        return TILE_EMPTY;
+    }
+
+    const Chunk &chunk = this->chunkAt(x, y);
+    int index = (y % CHUNK_TILES) * CHUNK_TILES + x % CHUNK_TILES;
+    return chunk.tiles[static_cast<std::size_t>(index)];
+}
+
+void Tilemap::buildChunk(Chunk &chunk) const {
+    const float size = static_cast<float>(TILE_SIZE);
+    const float tile_u = this->tileset.uv.w * size / this->tileset.rect.w;
+    const float tile_v = this->tileset.uv.h * size / this->tileset.rect.h;
+
+    chunk.xy.clear();
+    chunk.uv.clear();
+
+    for (int ty = 0; ty < CHUNK_TILES; ty++) {
+        for (int tx = 0; tx < CHUNK_TILES; tx++) {
+            Uint16 tile =
+                chunk.tiles[static_cast<std::size_t>(ty * CHUNK_TILES + tx)];
+            if (tile == TILE_EMPTY) {
+                continue;
+            }
+
+            int cell = tile - 1;
+            int column = cell % this->tileset_columns;
+            int row = cell / this->tileset_columns;
+            float u0 = this->tileset.uv.x + static_cast<float>(column) * tile_u;
+            float v0 = this->tileset.uv.y + static_cast<float>(row) * tile_v;
+            float left = static_cast<float>(tx) * size;
+            float top = static_cast<float>(ty) * size;
+
+            chunk.xy.insert(chunk.xy.end(),
+                            {left, top, left + size, top, left + size,
+                             top + size, left, top + size});
+            chunk.uv.insert(chunk.uv.end(),
+                            {u0, v0, u0 + tile_u, v0, u0 + tile_u, v0 + tile_v,
+                             u0, v0 + tile_v});
+        }
+    }
+
+    chunk.dirty = false;
+}
+
+// Only positions depend on the view, uvs are copied from the cache so a
+// chunk rebuilt later does not change a frame that is already batched.
+void Tilemap::batch(const Camera &camera, TilemapVertices &vertices) const {
+    vertices.xy.clear();
+    vertices.uv.clear();
+    vertices.chunk_quads.clear();
+    vertices.stats = {};
+
+    const SDL_FRect &view = camera.view();
+    const float scale = camera.zoom();
+    const float chunk_size = static_cast<float>(CHUNK_SIZE);
+
+    int first_x =
+        std::max(0, static_cast<int>(std::floor(view.x / chunk_size)));
+    int first_y =
+        std::max(0, static_cast<int>(std::floor(view.y / chunk_size)));
+    int last_x = std::min(this->chunk_columns - 1,
+                          static_cast<int>(std::floor((view.x + view.w) /
+                                                      chunk_size)));
+    int last_y = std::min(this->chunk_rows - 1,
+                          static_cast<int>(std::floor((view.y + view.h) /
+                                                      chunk_size)));
+
+    for (int cy = first_y; cy <= last_y; cy++) {
+        for (int cx = first_x; cx <= last_x; cx++) {
+            Chunk &chunk = this->chunks[static_cast<std::size_t>(
+                cy * this->chunk_columns + cx)];
+            if (chunk.dirty) {
+                this->buildChunk(chunk);
+                vertices.stats.chunks_rebuilt++;
+            }
+
+            std::size_t quads = chunk.xy.size() / 8;
+            if (quads == 0) {
+                continue;
+            }
+
+            const float offset_x =
+                (static_cast<float>(cx) * chunk_size - view.x) * scale;
+            const float offset_y =
+                (static_cast<float>(cy) * chunk_size - view.y) * scale;
+            std::size_t first = vertices.xy.size();
+            vertices.xy.resize(first + chunk.xy.size());
+            const float *__restrict src = chunk.xy.data();
+            float *__restrict dst = vertices.xy.data() + first;
+            for (std::size_t i = 0; i < quads * 4; i++) {
+                dst[i * 2] = src[i * 2] * scale + offset_x;
+                dst[i * 2 + 1] = src[i * 2 + 1] * scale + offset_y;
+            }
+            vertices.uv.insert(vertices.uv.end(), chunk.uv.begin(),
+                               chunk.uv.end());
+            vertices.chunk_quads.push_back(quads);
+
+            vertices.stats.chunks_drawn++;
+            vertices.stats.tiles_drawn += quads;
+        }
+    }
+
+    std::size_t visible = 0;
+    if (last_x >= first_x && last_y >= first_y) {
+        visible = static_cast<std::size_t>((last_x - first_x + 1) *
+                                           (last_y - first_y + 1));
+    }
+    vertices.stats.chunks_culled = this->chunks.size() - visible;
+}
+
+// A chunk holds at most CHUNK_QUADS quads, so every chunk shares the same
+// colors and indices. All chunks use the tileset's texture and sort together.
+void Tilemap::record(CommandBuffer &commands,
+                     const TilemapVertices &vertices) const {
+    SDL_Texture *texture = this->atlas.texture(this->tileset.page);
+    std::size_t first = 0;
+    for (std::size_t quads : vertices.chunk_quads) {
+        commands.addGeometry(RenderLayer::Background, texture,
+                             SDL_BLENDMODE_BLEND, &vertices.xy[first * 8],
+                             this->colors.data(), &vertices.uv[first * 8],
+                             static_cast<int>(quads * 4), this->indices.data(),
+                             static_cast<int>(quads * 6));
+        first += quads;
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include "atlas.h"
+#include "camera.h"
+#include "command_buffer.h"
+#include <vector>
+
+constexpr int TILE_SIZE = 32;
+constexpr int CHUNK_TILES = 16;
+constexpr int CHUNK_SIZE = TILE_SIZE * CHUNK_TILES;
+constexpr Uint16 TILE_EMPTY = 0;
+
+struct TilemapStats {
+        std::size_t chunks_drawn;
+        std::size_t chunks_culled;
+        std::size_t chunks_rebuilt;
+        std::size_t tiles_drawn;
+};
+
+// The visible chunks of one frame in screen coordinates, kept apart from the
+// map like ParticleVertices so a finished frame can be drawn while the next
+// one is being batched. chunk_quads holds the quads of each drawn chunk in
+// the order their vertices follow each other.
+struct TilemapVertices {
+        std::vector<float> xy;
+        std::vector<float> uv;
+        std::vector<std::size_t> chunk_quads;
+        TilemapStats stats;
+};
+
+// Tiles live in fixed size chunks. Each chunk caches its quads in chunk
+// local coordinates, built the first time the chunk is seen and rebuilt only
+// after setTile() marks it dirty. batch() skips chunks outside the camera
+// view, so the cost follows what is on screen rather than the size of the
+// map. record() adds one geometry command per chunk on the background layer,
+// below every entity.
+class Tilemap {
+    public:
+        Tilemap(const TextureAtlas &texture_atlas, const AtlasRegion &tileset,
+                int columns, int rows);
+
+        void setTile(int x, int y, Uint16 tile);
+        Uint16 tile(int x, int y) const;
+        void batch(const Camera &camera, TilemapVertices &vertices) const;
+        void record(CommandBuffer &commands,
+                    const TilemapVertices &vertices) const;
+
+        int columns() const { return this->map_columns; }
+        int rows() const { return this->map_rows; }
+        float width() const;
+        float height() const;
+
+    private:
+        struct Chunk {
+                std::vector<Uint16> tiles;
+                std::vector<float> xy;
+                std::vector<float> uv;
+                bool dirty;
+        };
+
+        Chunk &chunkAt(int x, int y);
+        const Chunk &chunkAt(int x, int y) const;
+        void buildChunk(Chunk &chunk) const;
+
+        const TextureAtlas &atlas;
+        AtlasRegion tileset;
+        int tileset_columns;
+        int map_columns;
+        int map_rows;
+        int chunk_columns;
+        int chunk_rows;
+
+        mutable std::vector<Chunk> chunks;
+        std::vector<SDL_FColor> colors;
+        std::vector<int> indices;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+struct TraceRecord {
+        const char *name;
+        Uint64 start;
+        Uint64 end;
+};
+
+// Only the owning thread writes records and count, other threads read the
+// first count records. The name is guarded by the registry mutex.
+struct TraceBuffer {
+        explicit TraceBuffer(Uint32 thread_id)
+            : id{thread_id},
+              thread_name{},
+              records{std::make_unique<TraceRecord[]>(TRACE_THREAD_EVENTS)},
+              count{0},
+              dropped{0} {}
+
+        Uint32 id;
+        std::string thread_name;
+        std::unique_ptr<TraceRecord[]> records;
+        std::atomic<std::size_t> count;
+        std::atomic<Uint64> dropped;
+};
+
+static std::atomic<bool> trace_active{false};
+static std::atomic<Uint64> trace_origin{0};
+static std::mutex trace_mutex;
+// Buffers outlive their threads, so events of finished workers are still
+// written out.
+static std::vector<std::unique_ptr<TraceBuffer>> trace_buffers;
+static thread_local TraceBuffer *trace_local = nullptr;
+
+static TraceBuffer &localBuffer() {
+    if (!trace_local) {
+        std::lock_guard lock{trace_mutex};
+        trace_buffers.push_back(std::make_unique<TraceBuffer>(
+            static_cast<Uint32>(trace_buffers.size() + 1)));
+        trace_local = trace_buffers.back().get();
+    }
+    return *trace_local;
+}
+
+void traceStart() {
+    trace_origin.store(SDL_GetTicksNS(), std::memory_order_relaxed);
+    trace_active.store(true, std::memory_order_release);
+}
+
+bool traceActive() { return trace_active.load(std::memory_order_relaxed); }
+
+void traceEvent(const char *name, Uint64 start_ns, Uint64 end_ns) {
+    TraceBuffer &buffer = localBuffer();
+    std::size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count == TRACE_THREAD_EVENTS) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.records[count] = {name, start_ns, end_ns};
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+void traceThreadName(std::string_view name) {
+    if (!traceActive()) {
+        return;
+    }
+    TraceBuffer &buffer = localBuffer();
+    std::lock_guard lock{trace_mutex};
+    buffer.thread_name = name;
+}
+
+// Complete events ("ph":"X") carry their start and duration in
+// microseconds, metadata events name the threads.
+std::size_t traceWrite(const char *path) {
+    const Uint64 origin = trace_origin.load(std::memory_order_relaxed);
+    auto micros = [origin](Uint64 ns) {
+        return static_cast<double>(ns - std::min(ns, origin)) / 1000.0;
+    };
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    std::size_t written = 0;
+    Uint64 dropped = 0;
+    {
+        std::lock_guard lock{trace_mutex};
+        for (const std::unique_ptr<TraceBuffer> &buffer : trace_buffers) {
+            std::string name = buffer->thread_name.empty()
+                                   ? std::format("thread {}", buffer->id)
+                                   : buffer->thread_name;
+            json += std::format("{}{{\"name\":\"thread_name\",\"ph\":\"M\","
+                                "\"pid\":1,\"tid\":{},\"args\":{{\"name\":"
+                                "\"{}\"}}}}",
+                                json.back() == '[' ? "" : ",", buffer->id,
+                                name);
+
+            std::size_t count =
+                buffer->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; i++) {
+                const TraceRecord &record = buffer->records[i];
+                json += std::format(",{{\"name\":\"{}\",\"ph\":\"X\","
+                                    "\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                                    "\"dur\":{:.3f}}}",
+                                    record.name, buffer->id,
+                                    micros(record.start),
+                                    micros(record.end) - micros(record.start));
+            }
+            written += count;
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    json += "]}\n";
+
+    if (!SDL_SaveFile(path, json.data(), json.size())) {
+        auto error = std::format("Error saving Trace: {}", SDL_GetError());
+        throw std::runtime_error(error);
+    }
+    if (dropped > 0) {
+        std::cerr << std::format("Trace buffers full, {} events dropped\n",
+                                 dropped);
+    }
+    return written;
+}
@@ -0,0 +1,50 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "main.h"
+#include <string>
+#include <string_view>
+
+// Events a thread can hold, later ones are dropped and counted.
+constexpr std::size_t TRACE_THREAD_EVENTS = 1 << 16;
+
+// Timing markers for a timeline of startup and frames, written as Chrome
+// trace JSON that chrome://tracing and ui.perfetto.dev open directly.
+//
+// Every thread appends to its own fixed buffer and publishes the new count
+// with a release store, so recording takes no lock and the file can be
+// written while other threads keep recording. Until traceStart() a scope
+// costs one relaxed load. Event names are not copied and have to outlive
+// the trace, in practice they are string literals.
+void traceStart();
+bool traceActive();
+void traceEvent(const char *name, Uint64 start_ns, Uint64 end_ns);
+
+// Shown in place of the thread id for the calling thread, ignored while
+// not tracing so idle threads get no buffer.
+void traceThreadName(std::string_view name);
+
+// Returns the number of events written.
+std::size_t traceWrite(const char *path);
+
+// Records the time from construction to the end of the scope.
+class TraceScope {
+    public:
+        explicit TraceScope(const char *scope_name)
+            : name{traceActive() ? scope_name : nullptr},
+              start{this->name ? SDL_GetTicksNS() : 0} {}
+        ~TraceScope() {
+            if (this->name) {
+                traceEvent(this->name, this->start, SDL_GetTicksNS());
+            }
+        }
+
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+
+    private:
+        const char *name;
+        Uint64 start;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+// Lock-free single producer, single consumer triple buffer. The producer
+// always has a slot to write, the consumer always has a complete slot to
+// read, and the third slot holds the most recently published value. Neither
+// side ever waits on the other; stale frames are simply overwritten.
+template <typename T>
+class TripleBuffer {
+    public:
+        template <typename... Args>
+        explicit TripleBuffer(const Args &...args)
+            : slots{T{args...}, T{args...}, T{args...}},
+              back_index{0},
+              middle{1},
+              front_index{2} {}
+
+        T &back() { return this->slots[this->back_index]; }
+        const T &front() const { return this->slots[this->front_index]; }
+
+        // Producer: hand the back slot over and take the stale middle one.
+        void publish() {
+            int previous = this->middle.exchange(this->back_index | FRESH,
+                                                 std::memory_order_acq_rel);
+            this->back_index = previous & INDEX_MASK;
+        }
+
+        // Consumer: swap in the newest slot, returns false if nothing new
+        // was published since the last call.
+        bool acquire() {
+            if (!(this->middle.load(std::memory_order_relaxed) & FRESH)) {
+                return false;
+            }
+            int previous = this->middle.exchange(this->front_index,
+                                                 std::memory_order_acq_rel);
+            this->front_index = previous & INDEX_MASK;
+            return true;
+        }
+
+    private:
+        static constexpr int FRESH = 4;
+        static constexpr int INDEX_MASK = 3;
+
+        std::array<T, 3> slots;
+        int back_index;
+        std::atomic<int> middle;
+        int front_index;
+};
+
+#endif
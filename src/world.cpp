@@ -0,0 +1,296 @@
+#include "world.h"
+#include "sdf_font.h"
+#include "tilemap.h"
+#include <cmath>
+
+// The window, or the tilemap where it is larger, so a level can scroll.
+static SDL_FRect worldBounds(const Scene &scene) {
+    int width = scene.window_w;
+    int height = scene.window_h;
+    if (scene.tilemap.image != SCENE_NONE) {
+        width = std::max(width, scene.tilemap.columns * TILE_SIZE);
+        height = std::max(height, scene.tilemap.rows * TILE_SIZE);
+    }
+    return {0, 0, static_cast<float>(width), static_cast<float>(height)};
+}
+
+World::World(const WorldSetup &setup)
+    : gen{},
+      world_bounds{worldBounds(setup.scene)},
+      draw_color{0, 0, 0, 255},
+      world_camera{static_cast<float>(setup.scene.window_w),
+                   static_cast<float>(setup.scene.window_h)},
+      world_particles{setup.particle_capacity},
+      world_animations{},
+      sprite{setup.scene.entities.sprite},
+      behavior{setup.scene.entities.behavior},
+      burst_color(sprite.size()),
+      pos_x{setup.scene.entities.x},
+      pos_y{setup.scene.entities.y},
+      width(sprite.size()),
+      height(sprite.size()),
+      vel_x{setup.scene.entities.speed_x},
+      vel_y{setup.scene.entities.speed_y},
+      speed_x(sprite.size()),
+      speed_y(sprite.size()),
+      angle(sprite.size()),
+      spin{setup.scene.entities.spin},
+      scale{setup.scene.entities.scale},
+      tint(sprite.size()),
+      animation(sprite.size(), ANIMATION_NONE),
+      player{SCENE_NONE} {
+    std::vector<AnimationClip> clips = animationClips(setup.scene);
+
+    for (std::size_t i = 0; i < this->sprite.size(); i++) {
+        const SceneAsset &asset = setup.scene.assets[this->sprite[i]];
+        this->burst_color[i] = asset.color;
+        SDL_Color tint_color = setup.scene.entities.tint[i];
+        this->tint[i] = {tint_color.r / 255.0f, tint_color.g / 255.0f,
+                         tint_color.b / 255.0f, tint_color.a / 255.0f};
+        this->width[i] = setup.sprite_sizes[this->sprite[i]].x;
+        this->height[i] = setup.sprite_sizes[this->sprite[i]].y;
+        if (asset.kind == AssetKind::Animation) {
+            std::size_t index = setup.scene.findAnimation(this->sprite[i]);
+            const SceneAnimation &scene_animation =
+                setup.scene.animations[index];
+            this->animation[i] = this->world_animations.add(clips[index]);
+            this->width[i] = static_cast<float>(scene_animation.frame_w);
+            this->height[i] = static_cast<float>(scene_animation.frame_h);
+        }
+        this->speed_x[i] = std::abs(this->vel_x[i]);
+        this->speed_y[i] = std::abs(this->vel_y[i]);
+
+        if (this->player == SCENE_NONE &&
+            this->behavior[i] == Behavior::Player) {
+            this->player = i;
+        }
+    }
+
+    this->updateCamera();
+}
+
+void World::seed(Uint64 seed, Uint64 stream) {
+    this->gen = Xoshiro256::stream(seed, stream);
+    this->world_particles.seed(this->gen());
+}
+
+WorldEvents World::update(const WorldInput &input) {
+    WorldEvents events{0, input.color_requests};
+
+    for (int i = 0; i < input.color_requests; i++) {
+        this->renderColor();
+    }
+    if (input.zoom_steps != 0) {
+        this->zoomCamera(
+            std::pow(CAMERA_ZOOM_STEP, static_cast<float>(input.zoom_steps)));
+    }
+
+    events.bounces = this->updateBouncers();
+    this->updatePlayers(input.keys);
+    this->updateSpin();
+    this->updateCamera();
+    this->world_particles.update(UPDATE_DT);
+    this->world_animations.update(UPDATE_DT);
+
+    return events;
+}
+
+Uint64 World::save(std::vector<std::byte> &buffer) const {
+    SnapshotWriter writer{buffer};
+
+    writer.write(this->gen.state());
+    writer.write(this->draw_color);
+    writer.write(this->world_camera.zoom());
+    writer.write(static_cast<Uint64>(this->sprite.size()));
+    for (const std::vector<float> *array :
+         {&this->pos_x, &this->pos_y, &this->vel_x, &this->vel_y,
+          &this->angle}) {
+        writer.writeArray(array->data(), array->size());
+    }
+    this->world_animations.save(writer);
+    this->world_particles.save(writer);
+
+    return writer.finish();
+}
+
+// A copy of the reader walks the whole snapshot first, so a damaged file or
+// one saved from another scene or with another particle capacity throws
+// without touching the world. Only then is it read straight into the live
+// arrays, which keep their storage, the particle indices that frames in
+// flight point at included. Only what moves is stored, everything else
+// comes from the scene.
+void World::load(std::span<const std::byte> data) {
+    SnapshotReader reader{data};
+
+    std::array<Uint64, 4> gen_state;
+    SDL_Color color;
+    float zoom = 1;
+    Uint64 saved_entities = 0;
+    reader.read(gen_state);
+    reader.read(color);
+    reader.read(zoom);
+    reader.read(saved_entities);
+    if (saved_entities != this->sprite.size()) {
+        auto error = std::format("Error reading Snapshot: {} entities, scene "
+                                 "has {}",
+                                 saved_entities, this->sprite.size());
+        throw std::runtime_error(error);
+    }
+
+    SnapshotReader check = reader;
+    check.skip<float>(this->sprite.size() * 5);
+    this->world_animations.check(check);
+    this->world_particles.check(check);
+
+    for (std::vector<float> *array :
+         {&this->pos_x, &this->pos_y, &this->vel_x, &this->vel_y,
+          &this->angle}) {
+        reader.readArray(array->data(), array->size());
+    }
+    this->world_animations.load(reader);
+    this->world_particles.load(reader);
+
+    this->draw_color = color;
+    this->gen.setState(gen_state);
+    this->world_camera.setZoom(zoom);
+    this->updateCamera();
+}
+
+void World::renderColor() {
+    // One draw covers all three channels. std distributions are avoided so
+    // a seed gives the same colors with every standard library.
+    Uint64 bits = this->gen();
+    this->draw_color = {static_cast<Uint8>(bits >> 40),
+                        static_cast<Uint8>(bits >> 48),
+                        static_cast<Uint8>(bits >> 56), 255};
+
+    this->world_particles.emit(
+        this->world_bounds.x + this->world_bounds.w / 2,
+        this->world_bounds.y + this->world_bounds.h / 2, PARTICLE_BURST,
+        this->draw_color);
+}
+
+int World::updateBouncers() {
+    int bounces = 0;
+
+    const float left = this->world_bounds.x;
+    const float top = this->world_bounds.y;
+    const float right = left + this->world_bounds.w;
+    const float bottom = top + this->world_bounds.h;
+
+    for (std::size_t i = 0; i < this->sprite.size(); i++) {
+        if (this->behavior[i] != Behavior::Bounce) {
+            continue;
+        }
+
+        float &x = this->pos_x[i];
+        float &y = this->pos_y[i];
+        x += this->vel_x[i];
+        y += this->vel_y[i];
+
+        float center_x = x + this->width[i] / 2;
+        float center_y = y + this->height[i] / 2;
+        SDL_Color color = this->burst_color[i];
+
+        if (x < left) {
+            this->vel_x[i] = this->speed_x[i];
+            bounces++;
+            this->world_particles.emit(left, center_y, PARTICLE_BURST, color);
+        } else if (x + this->width[i] > right) {
+            this->vel_x[i] = -this->speed_x[i];
+            bounces++;
+            this->world_particles.emit(right, center_y, PARTICLE_BURST, color);
+        }
+        if (y < top) {
+            this->vel_y[i] = this->speed_y[i];
+            bounces++;
+            this->world_particles.emit(center_x, top, PARTICLE_BURST, color);
+        } else if (y + this->height[i] > bottom) {
+            this->vel_y[i] = -this->speed_y[i];
+            bounces++;
+            this->world_particles.emit(center_x, bottom, PARTICLE_BURST,
+                                       color);
+        }
+    }
+
+    return bounces;
+}
+
+void World::updatePlayers(Uint8 keys) {
+    float dx = 0;
+    float dy = 0;
+    if (keys & INPUT_LEFT) {
+        dx -= 1;
+    }
+    if (keys & INPUT_RIGHT) {
+        dx += 1;
+    }
+    if (keys & INPUT_UP) {
+        dy -= 1;
+    }
+    if (keys & INPUT_DOWN) {
+        dy += 1;
+    }
+
+    for (std::size_t i = 0; i < this->sprite.size(); i++) {
+        if (this->behavior[i] == Behavior::Player) {
+            this->pos_x[i] += dx * this->speed_x[i];
+            this->pos_y[i] += dy * this->speed_y[i];
+        }
+    }
+}
+
+// Angles stay within a turn so they keep their precision however long the
+// entity spins.
+void World::updateSpin() {
+    for (std::size_t i = 0; i < this->sprite.size(); i++) {
+        float turned = this->angle[i] + this->spin[i];
+        this->angle[i] = turned - 360 * std::floor(turned / 360);
+    }
+}
+
+// Follows the first player, a scene without one keeps the camera centered.
+void World::updateCamera() {
+    if (this->player != SCENE_NONE) {
+        SDL_FRect rect = this->entityRect(this->player);
+        this->world_camera.centerOn(rect.x + rect.w / 2, rect.y + rect.h / 2);
+    }
+    this->world_camera.clampTo(this->world_bounds);
+}
+
+void World::zoomCamera(float factor) {
+    this->world_camera.setZoom(this->world_camera.zoom() * factor);
+    this->updateCamera();
+}
+
+// Measures every image and text in the scene the same way Game::loadMedia
+// does, without needing a renderer.
+WorldSetup loadWorldSetup(const Scene &scene) {
+    WorldSetup setup{scene, std::vector<SDL_FPoint>(scene.assets.size()),
+                     PARTICLE_CAPACITY};
+    std::vector<SdfFont> fonts(scene.assets.size());
+
+    for (std::size_t i = 0; i < scene.assets.size(); i++) {
+        const SceneAsset &asset = scene.assets[i];
+
+        if (asset.kind == AssetKind::Image) {
+            std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)> surf{
+                IMG_Load(asset.path.c_str()), SDL_DestroySurface};
+            if (!surf) {
+                auto error =
+                    std::format("Error loading Surface: {}", SDL_GetError());
+                throw std::runtime_error(error);
+            }
+            setup.sprite_sizes[i] = {static_cast<float>(surf->w),
+                                     static_cast<float>(surf->h)};
+        } else if (asset.kind == AssetKind::Text) {
+            SdfFont &font = fonts[asset.font];
+            if (!font.loaded()) {
+                font.load(scene.assets[asset.font].path);
+            }
+            setup.sprite_sizes[i] = font.measure(asset.path, asset.size);
+        }
+    }
+
+    return setup;
+}
@@ -0,0 +1,121 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "animation.h"
+#include "camera.h"
+#include "particles.h"
+#include "scene.h"
+
+constexpr Uint8 INPUT_LEFT = 1 << 0;
+constexpr Uint8 INPUT_RIGHT = 1 << 1;
+constexpr Uint8 INPUT_UP = 1 << 2;
+constexpr Uint8 INPUT_DOWN = 1 << 3;
+
+// The scene plus the pixel size of every asset, indexed like scene.assets.
+// Sizes come from the atlas in the game and from measuring the files in
+// headless runs.
+struct WorldSetup {
+        Scene scene;
+        std::vector<SDL_FPoint> sprite_sizes;
+        std::size_t particle_capacity;
+};
+
+struct WorldInput {
+        Uint8 keys;
+        int color_requests;
+        int zoom_steps;
+};
+
+// What happened during a step that the owner may want to play sounds for.
+struct WorldEvents {
+        int bounces;
+        int color_changes;
+};
+
+// The simulated part of the game with no window, renderer or audio attached,
+// so many worlds can be stepped side by side on different threads. Entities
+// are kept as structure-of-arrays in scene order, which is also draw order
+// within a layer.
+class World {
+    public:
+        explicit World(const WorldSetup &setup);
+
+        // Worlds sharing a seed but given different streams draw independent
+        // sequences, so every headless world is reproducible on its own.
+        void seed(Uint64 seed, Uint64 stream = 0);
+        WorldEvents update(const WorldInput &input);
+
+        // The whole simulation state including both generators, so a loaded
+        // world continues exactly as the saved one would have. Returns the
+        // snapshot hash, equal hashes mean equal states.
+        Uint64 save(std::vector<std::byte> &buffer) const;
+        void load(std::span<const std::byte> data);
+
+        std::size_t entities() const { return this->sprite.size(); }
+        SDL_FRect entityRect(std::size_t entity) const {
+            return {this->pos_x[entity], this->pos_y[entity],
+                    this->width[entity], this->height[entity]};
+        }
+        Uint32 entitySprite(std::size_t entity) const {
+            return this->sprite[entity];
+        }
+        Behavior entityBehavior(std::size_t entity) const {
+            return this->behavior[entity];
+        }
+        SpriteTransform entityTransform(std::size_t entity) const {
+            return {this->angle[entity], this->scale[entity],
+                    this->tint[entity]};
+        }
+        // Index into the baked animation frames, ANIMATION_NONE for
+        // entities that are not animated.
+        Uint32 entityFrame(std::size_t entity) const {
+            Uint32 instance = this->animation[entity];
+            return instance == ANIMATION_NONE
+                       ? ANIMATION_NONE
+                       : this->world_animations.frame(instance);
+        }
+
+        const SDL_FRect &bounds() const { return this->world_bounds; }
+        SDL_Color drawColor() const { return this->draw_color; }
+        const Camera &camera() const { return this->world_camera; }
+        const ParticleSystem &particles() const {
+            return this->world_particles;
+        }
+
+    private:
+        void renderColor();
+        int updateBouncers();
+        void updatePlayers(Uint8 keys);
+        void updateSpin();
+        void updateCamera();
+        void zoomCamera(float factor);
+
+        Xoshiro256 gen;
+        SDL_FRect world_bounds;
+        SDL_Color draw_color;
+        Camera world_camera;
+        ParticleSystem world_particles;
+        AnimationPlayer world_animations;
+
+        std::vector<Uint32> sprite;
+        std::vector<Behavior> behavior;
+        std::vector<SDL_Color> burst_color;
+        std::vector<float> pos_x;
+        std::vector<float> pos_y;
+        std::vector<float> width;
+        std::vector<float> height;
+        std::vector<float> vel_x;
+        std::vector<float> vel_y;
+        std::vector<float> speed_x;
+        std::vector<float> speed_y;
+        std::vector<float> angle;
+        std::vector<float> spin;
+        std::vector<float> scale;
+        std::vector<SDL_FColor> tint;
+        std::vector<Uint32> animation;
+        std::size_t player;
+};
+
+WorldSetup loadWorldSetup(const Scene &scene);
+
+#endif